@@ -1,5 +1,8 @@
 #define FASTLED_INTERNAL
 #include "FastLED.h"
+#if FASTLED_OUTPUT_BYPASS == 1
+#include <math.h>
+#endif
 
 
 #if defined(__SAM3X8E__)
@@ -12,9 +15,60 @@ void *pSmartMatrix = NULL;
 
 CFastLED FastLED;
 
-CLEDController *CLEDController::m_pHead = NULL;
-CLEDController *CLEDController::m_pTail = NULL;
+CLEDController *CLEDController::m_pControllers[FASTLED_MAX_CONTROLLERS];
+uint8_t CLEDController::m_nControllers = 0;
+bool CLEDController::m_bInShow = false;
+
+#if FASTLED_OUTPUT_BYPASS == 1
+void CLEDController::buildOutputTable(CRGB scale) {
+	if(!m_pOutputTable) { return; }
+	// scales of 1-255 count as 2-256 as they do in scale8, so that a scale of 255 passes values through unchanged
+	float s[3];
+	for(uint8_t c = 0; c < 3; c++) { s[c] = scale.raw[c] ? (scale.raw[c] + 1) / 256.0f : 0.0f; }
+
+	for(int i = 0; i < 256; i++) {
+		float v = (m_fGamma == 1.0f) ? (float)i : (255.0f * pow(i / 255.0f, m_fGamma));
+		for(uint8_t c = 0; c < 3; c++) {
+			m_pOutputTable[(c << 8) + i] = (uint8_t)(v * s[c] + 0.5f);
+		}
+	}
+}
+#endif
+
+void CLEDController::reduce16(const struct CRGB16 *src, struct CRGB *dst, int nLeds, CRGB scale, EDitherMode dither, uint8_t ditherBits, uint8_t ditherPhase) {
+	// threshold added to the dropped bits of each pixel in a group of four - the same signal PixelController
+	// uses for 8 bit data, but applied to the real remainder rather than a guessed one
+	uint8_t t[4] = { 0x80, 0x80, 0x80, 0x80 };
+#if !defined(NO_DITHERING) || (NO_DITHERING != 1)
+	if(dither == BINARY_DITHER && ditherBits) {
+		uint8_t Q = PixelController<RGB>::ditherSignal(ditherPhase, ditherBits);
+		t[0] = t[2] = Q;
+		t[1] = t[3] = ~Q;
+	} else if(dither == BAYER_DITHER) {
+		if(ditherBits > 6) { ditherBits = 6; }
+		uint8_t Q = PixelController<RGB>::ditherSignal(ditherPhase, ditherBits) >> 2;
+		t[0] = Q;
+		t[1] = ~Q;
+		t[2] = Q + 0x40;
+		t[3] = ~(Q + 0x40);
+	}
+#endif
+
+	// scales of 1-255 count as 2-256, so that 255 keeps the full range, with the top byte of the result being
+	// written out
+	uint16_t s[3];
+	for(uint8_t c = 0; c < 3; c++) { s[c] = scale.raw[c] ? scale.raw[c] + 1 : 0; }
+
+	for(int i = 0; i < nLeds; i++) {
+		uint32_t bias = (uint32_t)t[i & 3] << 8;
+		for(uint8_t c = 0; c < 3; c++) {
+			uint32_t v = ((uint32_t)src[i].raw[c] * s[c] + bias) >> 16;
+			dst[i].raw[c] = (v > 255) ? 255 : v;
+		}
+	}
+}
 static uint32_t lastshow = 0;
+static bool lastshowValid = false;
 
 uint32_t _frame_cnt=0;
 uint32_t _retry_cnt=0;
@@ -28,6 +82,23 @@ CFastLED::CFastLED() {
 	m_nFPS = 0;
 	m_pPowerFunc = NULL;
 	m_nPowerData = 0xFFFFFFFF;
+	m_bSkipUnchanged = false;
+	m_nKeepAlive = 1000;
+	m_pIdleFunc = NULL;
+	m_bPredictPower = false;
+	m_nPowerMargin = 10;
+	m_nPowerHysteresis = 4;
+	m_nPredictedScale = 255;
+	m_nMeasuredPower = 0;
+	m_nPredictionError = m_nMaxPredictionError = 0;
+	for(uint8_t i = 0; i < FASTLED_POWER_ZONES; i++) {
+		m_nZonePowerData[i] = 0;
+		m_nZoneScale[i] = 0;
+		m_nZonePower[i] = 0;
+	}
+#if FASTLED_PROFILE == 1
+	m_nMissedFrames = 0;
+#endif
 }
 
 CLEDController &CFastLED::addLeds(CLEDController *pLed,
@@ -36,6 +107,9 @@ CLEDController &CFastLED::addLeds(CLEDController *pLed,
 	int nOffset = (nLedsIfOffset > 0) ? nLedsOrOffset : 0;
 	int nLeds = (nLedsIfOffset > 0) ? nLedsIfOffset : nLedsOrOffset;
 
+	// controllers register themselves when created, this is for adding back a removed one.  With
+	// FASTLED_MAX_CONTROLLERS registered already, the controller is handed back untouched and never shown
+	if(!pLed->registerController()) { return *pLed; }
 	pLed->init();
 	pLed->setLeds(data + nOffset, nLeds);
 	FastLED.setMaxRefreshRate(pLed->getMaxRefreshRate(),true);
@@ -43,66 +117,222 @@ CLEDController &CFastLED::addLeds(CLEDController *pLed,
 }
 
 void CFastLED::show(uint8_t scale) {
+	showAsync(scale);
+	waitForShow();
+}
+
+void CFastLED::waitForFrameSlot() {
+	uint32_t start = micros();
+	uint32_t now = start;
+	if(m_nMinMicros == 0 || !lastshowValid) {
+		// nothing to wait for (or measure lateness against) before the first frame
+		lastshow = now;
+		lastshowValid = true;
+	} else {
+		while((now - lastshow) < m_nMinMicros) {
+			if(m_pIdleFunc) {
+				(*m_pIdleFunc)(m_nMinMicros - (now - lastshow));
+			} else {
+				yield();
+			}
+			now = micros();
+		}
+
+		// stay on the grid of frame slots unless we fell a whole frame behind it, so that
+		// the time lost overshooting one slot gets made up by waiting less for the next one
+		uint32_t late = (now - lastshow) - m_nMinMicros;
+		lastshow = (late < m_nMinMicros) ? (lastshow + m_nMinMicros) : now;
+#if FASTLED_PROFILE == 1
+		m_LateStats.add(late);
+		// if we didn't get to wait at all, the frame slot had already begun
+		if(now == start) { m_nMissedFrames++; }
+#endif
+	}
+#if FASTLED_PROFILE == 1
+	m_WaitStats.add(now - start);
+#endif
+}
+
+uint32_t CFastLED::getMicrosUntilNextFrame() {
+	uint32_t elapsed = micros() - lastshow;
+	return (elapsed < m_nMinMicros) ? (m_nMinMicros - elapsed) : 0;
+}
+
+void CFastLED::showAsync(uint8_t scale) {
 	// guard against showing too rapidly
-	while(m_nMinMicros && ((micros()-lastshow) < m_nMinMicros));
-	lastshow = micros();
+	waitForFrameSlot();
 
-	// If we have a function for computing power, use it!
-	if(m_pPowerFunc) {
+	// pick up the newest frames from controllers fed by a rendering task
+	for(uint8_t i = 0; i < CLEDController::m_nControllers; i++) {
+		CLEDController::m_pControllers[i]->acquireFrame();
+	}
+
+#if FASTLED_PROFILE == 1
+	uint32_t start = micros();
+#endif
+	bool bZoneLimits = false;
+	for(uint8_t i = 0; i < FASTLED_POWER_ZONES; i++) {
+		if(m_nZonePowerData[i]) { bZoneLimits = true; }
+	}
+
+	// If we have a function for computing power, use it!  The led data gets added up only once, for the
+	// global limit and the power zones together
+	if(m_pPowerFunc && m_bPredictPower && m_nMeasuredPower) {
+		// the zones go by the power measured for the previous frame as well
+		scale = predictBrightness(scale);
+	} else if(bZoneLimits) {
+		uint32_t total_mW = calculate_unscaled_power_mW(m_nZonePower);
+		if(m_pPowerFunc) {
+			// the second half of calculate_max_brightness_for_power_mW, indicator led and debug output included
+			scale = calculate_max_brightness_for_unscaled_power_mW(total_mW, scale, m_nPowerData);
+			m_nPredictedScale = scale;
+		}
+	} else if(m_pPowerFunc) {
 		scale = (*m_pPowerFunc)(scale, m_nPowerData);
+		m_nPredictedScale = scale;
 	}
+	// then dim the power zones that would still draw too much on their own
+	for(uint8_t i = 0; i < FASTLED_POWER_ZONES; i++) {
+		m_nZoneScale[i] = m_nZonePowerData[i] ? calculate_max_brightness_for_zone_mW(m_nZonePower[i], scale, m_nZonePowerData[i]) : scale;
+	}
+#if FASTLED_PROFILE == 1
+	uint32_t first = micros();
+	m_PowerStats.add(first - start);
+	start = first;
+#endif
 
-	CLEDController *pCur = CLEDController::head();
-	while(pCur) {
-		uint8_t d = pCur->getDither();
-		if(m_nFPS < 100) { pCur->setDither(0); }
-		pCur->showLeds(scale);
-		pCur->setDither(d);
-		pCur = pCur->next();
+	CLEDController::m_bInShow = true;
+	for(uint8_t i = 0; i < CLEDController::m_nControllers; i++) {
+		CLEDController *pCur = CLEDController::m_pControllers[i];
+		uint8_t zone = pCur->getPowerZone();
+		uint8_t s = zone ? m_nZoneScale[zone-1] : scale;
+		if(m_bSkipUnchanged || pCur->getTruncatedFrames()) {
+			pCur->showLedsIfChanged(s, m_nKeepAlive);
+		} else {
+			pCur->showLeds(s);
+		}
+#if FASTLED_PROFILE == 1
+		uint32_t now = micros();
+		pCur->m_ShowStats.add(now - start);
+		start = now;
+#endif
+	}
+	endShow();
+#if FASTLED_PROFILE == 1
+	m_ShowStats.add(start - first);
+#endif
+	if(m_pPowerFunc && m_bPredictPower) {
+		measurePower(scale);
 	}
 	countFPS();
 }
 
-int CFastLED::count() {
-    int x = 0;
-	CLEDController *pCur = CLEDController::head();
-	while( pCur) {
-        x++;
-		pCur = pCur->next();
+uint8_t CFastLED::predictBrightness(uint8_t target) {
+	uint32_t budget = m_nPowerData - ((m_nPowerData / 100) * m_nPowerMargin);
+	// the same limit as without prediction, so the indicator led and debug output still show limiting
+	uint8_t scale = calculate_max_brightness_for_unscaled_power_mW(m_nMeasuredPower, target, budget);
+
+	// a single dark frame shouldn't let the next one go all the way up
+	if(scale > m_nPredictedScale && (scale - m_nPredictedScale) > m_nPowerHysteresis) {
+		scale = m_nPredictedScale + m_nPowerHysteresis;
 	}
-    return x;
+	m_nPredictedScale = scale;
+	return scale;
 }
 
-CLEDController & CFastLED::operator[](int x) {
-	CLEDController *pCur = CLEDController::head();
-	while(x-- && pCur) {
-		pCur = pCur->next();
+void CFastLED::measurePower(uint8_t scale) {
+	uint32_t measured = calculate_unscaled_power_mW(m_nZonePower);
+	if(m_nMeasuredPower) {
+		m_nPredictionError = (int32_t)((measured * scale) / 256) - (int32_t)((m_nMeasuredPower * scale) / 256);
+		if(m_nPredictionError > m_nMaxPredictionError) { m_nMaxPredictionError = m_nPredictionError; }
 	}
-	if(pCur == NULL) {
+	m_nMeasuredPower = measured;
+}
+
+
+
+int CFastLED::count() {
+	return CLEDController::m_nControllers;
+}
+
+CLEDController & CFastLED::operator[](int x) {
+	if(x < 0 || x >= CLEDController::m_nControllers) {
 		return *(CLEDController::head());
 	} else {
-		return *pCur;
+		return *(CLEDController::m_pControllers[x]);
 	}
 }
 
 void CFastLED::showColor(const struct CRGB & color, uint8_t scale) {
-	while(m_nMinMicros && ((micros()-lastshow) < m_nMinMicros));
-	lastshow = micros();
+	waitForFrameSlot();
 
+#if FASTLED_PROFILE == 1
+	uint32_t start = micros();
+#endif
 	// If we have a function for computing power, use it!
 	if(m_pPowerFunc) {
 		scale = (*m_pPowerFunc)(scale, m_nPowerData);
 	}
+	// then dim the power zones that would still draw too much on their own, every led shows the same color
+	uint32_t zone_mW[FASTLED_POWER_ZONES] = { 0 };
+	for(uint8_t i = 0; i < CLEDController::m_nControllers; i++) {
+		CLEDController *pCur = CLEDController::m_pControllers[i];
+		uint8_t zone = pCur->getPowerZone();
+		if(zone) {
+			uint32_t n = pCur->size();
+			zone_mW[zone-1] += calculate_unscaled_power_mW(color.r * n, color.g * n, color.b * n, n);
+		}
+	}
+	for(uint8_t i = 0; i < FASTLED_POWER_ZONES; i++) {
+		m_nZoneScale[i] = m_nZonePowerData[i] ? calculate_max_brightness_for_zone_mW(zone_mW[i], scale, m_nZonePowerData[i]) : scale;
+	}
+#if FASTLED_PROFILE == 1
+	uint32_t first = micros();
+	m_PowerStats.add(first - start);
+	start = first;
+#endif
 
-	CLEDController *pCur = CLEDController::head();
-	while(pCur) {
-		uint8_t d = pCur->getDither();
-		if(m_nFPS < 100) { pCur->setDither(0); }
-		pCur->showColor(color, scale);
-		pCur->setDither(d);
-		pCur = pCur->next();
+	CLEDController::m_bInShow = true;
+	for(uint8_t i = 0; i < CLEDController::m_nControllers; i++) {
+		CLEDController *pCur = CLEDController::m_pControllers[i];
+		uint8_t zone = pCur->getPowerZone();
+		pCur->showColor(color, zone ? m_nZoneScale[zone-1] : scale);
+		pCur->invalidate();
+#if FASTLED_PROFILE == 1
+		uint32_t now = micros();
+		pCur->m_ShowStats.add(now - start);
+		start = now;
+#endif
 	}
+	endShow();
+#if FASTLED_PROFILE == 1
+	m_ShowStats.add(start - first);
+#endif
 	countFPS();
+	waitForShow();
+}
+
+void CFastLED::endShow() {
+	CLEDController::m_bInShow = false;
+	for(uint8_t i = 0; i < CLEDController::m_nControllers; i++) {
+		CLEDController *pCur = CLEDController::m_pControllers[i];
+		pCur->endShow();
+	}
+}
+
+bool CFastLED::isBusy() {
+	for(uint8_t i = 0; i < CLEDController::m_nControllers; i++) {
+		CLEDController *pCur = CLEDController::m_pControllers[i];
+		if(pCur->isBusy()) { return true; }
+	}
+	return false;
+}
+
+void CFastLED::waitForShow() {
+	for(uint8_t i = 0; i < CLEDController::m_nControllers; i++) {
+		CLEDController *pCur = CLEDController::m_pControllers[i];
+		pCur->waitForShow();
+	}
 }
 
 void CFastLED::clear(bool writeData) {
@@ -113,10 +343,9 @@ void CFastLED::clear(bool writeData) {
 }
 
 void CFastLED::clearData() {
-	CLEDController *pCur = CLEDController::head();
-	while(pCur) {
+	for(uint8_t i = 0; i < CLEDController::m_nControllers; i++) {
+		CLEDController *pCur = CLEDController::m_pControllers[i];
 		pCur->clearLedData();
-		pCur = pCur->next();
 	}
 }
 
@@ -134,27 +363,38 @@ void CFastLED::delay(unsigned long ms) {
 	while((millis()-start) < ms);
 }
 
+#if FASTLED_PROFILE == 1
+void CFastLED::resetStats() {
+	m_WaitStats.reset();
+	m_PowerStats.reset();
+	m_ShowStats.reset();
+	m_LateStats.reset();
+	m_nMissedFrames = 0;
+	for(uint8_t i = 0; i < CLEDController::m_nControllers; i++) {
+		CLEDController *pCur = CLEDController::m_pControllers[i];
+		pCur->m_ShowStats.reset();
+	}
+}
+#endif
+
 void CFastLED::setTemperature(const struct CRGB & temp) {
-	CLEDController *pCur = CLEDController::head();
-	while(pCur) {
+	for(uint8_t i = 0; i < CLEDController::m_nControllers; i++) {
+		CLEDController *pCur = CLEDController::m_pControllers[i];
 		pCur->setTemperature(temp);
-		pCur = pCur->next();
 	}
 }
 
 void CFastLED::setCorrection(const struct CRGB & correction) {
-	CLEDController *pCur = CLEDController::head();
-	while(pCur) {
+	for(uint8_t i = 0; i < CLEDController::m_nControllers; i++) {
+		CLEDController *pCur = CLEDController::m_pControllers[i];
 		pCur->setCorrection(correction);
-		pCur = pCur->next();
 	}
 }
 
 void CFastLED::setDither(uint8_t ditherMode)  {
-	CLEDController *pCur = CLEDController::head();
-	while(pCur) {
+	for(uint8_t i = 0; i < CLEDController::m_nControllers; i++) {
+		CLEDController *pCur = CLEDController::m_pControllers[i];
 		pCur->setDither(ditherMode);
-		pCur = pCur->next();
 	}
 }
 
@@ -210,6 +450,8 @@ void CFastLED::countFPS(int nFrames) {
   if(br++ >= nFrames) {
 		uint32_t now = millis();
 		now -= lastframe;
+		// on fast hosts nFrames can go by within a single millisecond, keep counting
+		if(now == 0) { return; }
 		m_nFPS = (br * 1000) / now;
     br = 0;
     lastframe = millis();
@@ -230,7 +472,9 @@ void CFastLED::setMaxRefreshRate(uint16_t refresh, bool constrain) {
   }
 }
 
+#if !defined(FASTLED_POSIX)
 extern "C" int atexit(void (* /*func*/ )()) { return 0; }
+#endif
 
 #ifdef FASTLED_NEEDS_YIELD
 extern "C" void yield(void) { }
@@ -42,6 +42,8 @@
 
 // Utility functions
 #include "fastled_delay.h"
+#include "fastled_profile.h"
+#include "triple_buffer.h"
 #include "bitswap.h"
 
 #include "controller.h"
@@ -166,6 +168,7 @@ enum EBlockChipsets {
 #endif
 
 typedef uint8_t (*power_func)(uint8_t scale, uint32_t data);
+typedef void (*idle_func)(uint32_t usRemaining);
 
 /// High level controller interface for FastLED.  This class manages controllers, global settings and trackings
 /// such as brightness, and refresh rates, and provides access functions for driving led data to controllers
@@ -178,6 +181,38 @@ class CFastLED {
 	uint32_t m_nMinMicros;		///< minimum µs between frames, used for capping frame rates.
 	uint32_t m_nPowerData;		///< max power use parameter
 	power_func m_pPowerFunc;	///< function for overriding brightness when using FastLED.show();
+	bool m_bSkipUnchanged;		///< only write out controllers whose data or settings changed
+	uint16_t m_nKeepAlive;		///< ms after which unchanged controllers get written out anyway
+	idle_func m_pIdleFunc;		///< function called while waiting for the next frame slot
+	bool m_bPredictPower;		///< pick the brightness from the power measured for the previous frame
+	uint8_t m_nPowerMargin;		///< percentage of the power limit held back when predicting
+	uint8_t m_nPowerHysteresis;	///< brightness steps per frame that the predicted brightness may rise by
+	uint8_t m_nPredictedScale;	///< brightness picked for the previous frame
+	uint32_t m_nMeasuredPower;	///< unscaled power measured for the previous frame, in mW - 0 if unknown
+	int32_t m_nPredictionError;	///< measured minus predicted power for the previous frame, in mW
+	int32_t m_nMaxPredictionError;	///< largest m_nPredictionError since the last reset
+	uint32_t m_nZonePowerData[FASTLED_POWER_ZONES];	///< max power use of each power zone, 0 for no limit
+	uint8_t m_nZoneScale[FASTLED_POWER_ZONES];		///< brightness picked for each power zone in the last frame
+	uint32_t m_nZonePower[FASTLED_POWER_ZONES];		///< unscaled power of each power zone, measured along with m_nMeasuredPower
+#if FASTLED_PROFILE == 1
+	CTimingStats m_WaitStats;		///< time spent waiting for the max refresh rate
+	CTimingStats m_PowerStats;	///< time spent in the power limiting function
+	CTimingStats m_ShowStats;		///< time spent writing out all controllers
+	CTimingStats m_LateStats;		///< how late frames started relative to their frame slot
+	uint32_t m_nMissedFrames;		///< frames that were shown after their frame slot had already begun
+#endif
+
+	/// wait for the next frame slot, as set by setMaxRefreshRate
+	void waitForFrameSlot();
+
+	/// pick the brightness for this frame from the power measured for the previous one
+	uint8_t predictBrightness(uint8_t target);
+
+	/// measure the power drawn by the frame just shown at the given brightness
+	void measurePower(uint8_t scale);
+
+	/// let all controllers know that they were handed the whole frame
+	void endShow();
 
 public:
 	CFastLED();
@@ -193,9 +228,16 @@ public:
 	/// @param data - base point to an array of CRGB data structures
 	/// @param nLedsOrOffset - number of leds (3 argument version) or offset into the data array
 	/// @param nLedsIfOffset - number of leds (4 argument version)
-	/// @returns a reference to the added controller
+	/// @returns a reference to the added controller.  If FASTLED_MAX_CONTROLLERS controllers were added already, it
+	/// doesn't get initialized or shown, and its index() is CLEDController::NO_CONTROLLER
 	static CLEDController &addLeds(CLEDController *pLed, struct CRGB *data, int nLedsOrOffset, int nLedsIfOffset = 0);
 
+	/// Remove a controller, so that show and friends no longer write out to it.  It can be added back later
+	/// with the controller pointer version of addLeds, possibly with different led data.  To just change the led
+	/// data or number of leds of a controller, use CLEDController::setLeds.
+	/// @param pLed - the led controller being removed
+	static void removeLeds(CLEDController *pLed) { pLed->unregisterController(); }
+
 	/// @name Adding SPI based controllers
   //@{
 	/// Add an SPI based  CLEDController instance to the world.
@@ -477,6 +519,53 @@ public:
 	/// @param milliwatts - the max power draw desired, in milliwatts
 	inline void setMaxPowerInMilliWatts(uint32_t milliwatts) { m_pPowerFunc = &calculate_max_brightness_for_power_mW; m_nPowerData = milliwatts; }
 
+	/// Set the maximum power to be used by the leds of one power zone, given in milliwatts.  Controllers
+	/// get assigned to zones with CLEDController::setPowerZone.  Each zone gets dimmed on its own as
+	/// needed to stay within its limit, on top of the global limit set with setMaxPowerInMilliWatts.
+	/// @param zone - the zone, from 1 to FASTLED_POWER_ZONES
+	/// @param milliwatts - the max power draw desired, in milliwatts - 0 for no limit
+	void setZoneMaxPowerInMilliWatts(uint8_t zone, uint32_t milliwatts) {
+		if(zone > 0 && zone <= FASTLED_POWER_ZONES) { m_nZonePowerData[zone-1] = milliwatts; }
+	}
+
+	/// Set the maximum power to be used by the leds of one power zone, given in volts and milliamps.
+	/// @param zone - the zone, from 1 to FASTLED_POWER_ZONES
+	/// @param volts - how many volts the leds of the zone are being driven at (usually 5)
+	/// @param milliamps - the maximum milliamps of power draw you want
+	void setZoneMaxPowerInVoltsAndMilliamps(uint8_t zone, uint8_t volts, uint32_t milliamps) { setZoneMaxPowerInMilliWatts(zone, volts * milliamps); }
+
+	/// Get the brightness the leds of a power zone were last shown at
+	/// @param zone - the zone, from 1 to FASTLED_POWER_ZONES
+	uint8_t getZoneBrightness(uint8_t zone) { return (zone > 0 && zone <= FASTLED_POWER_ZONES) ? m_nZoneScale[zone-1] : 0; }
+
+	/// Predict the power draw of each frame from the one before, rather than adding up all the led data
+	/// before any output starts.  The led data then only gets measured once the frame was handed to the
+	/// controllers, which overlaps with the output when using showAsync.  As a frame can draw more than the
+	/// one before, part of the power limit is held back, and the brightness only rises gradually.
+	/// @param predict - true to predict the power draw, false to compute it up front for every frame
+	/// @param margin - percentage of the power limit to hold back, from 0 to 100 (larger values are taken as 100)
+	/// @param hysteresis - by how much the brightness may rise per frame, it drops as far as needed right away
+	void setPowerPrediction(bool predict, uint8_t margin = 10, uint8_t hysteresis = 4) {
+		m_bPredictPower = predict; m_nPowerMargin = (margin > 100) ? 100 : margin; m_nPowerHysteresis = hysteresis; m_nMeasuredPower = 0;
+	}
+
+	/// Get how far off the power prediction for the last frame was
+	/// @returns the measured minus the predicted power draw, in milliwatts - positive if the frame drew more than predicted
+	int32_t getPowerPredictionError() { return m_nPredictionError; }
+
+	/// Get the largest power prediction error since the last call to resetPowerPredictionError, see getPowerPredictionError
+	int32_t getMaxPowerPredictionError() { return m_nMaxPredictionError; }
+
+	/// reset the largest power prediction error
+	void resetPowerPredictionError() { m_nPredictionError = m_nMaxPredictionError = 0; }
+
+	/// Only write out the controllers whose led data, brightness, color correction/temperature or dithering
+	/// mode changed since their last write (see CLEDController::showLedsIfChanged).  Useful when most strips
+	/// show static content, as it frees up the time otherwise spent re-sending the same data.
+	/// @param skip - true to skip unchanged controllers in show()
+	/// @param keepAlive - write out unchanged controllers anyway after this many milliseconds, 0 to never do that
+	void setSkipUnchanged(bool skip, uint16_t keepAlive = 1000) { m_bSkipUnchanged = skip; m_nKeepAlive = keepAlive; }
+
 	/// Update all our controllers with the current led colors, using the passed in brightness
 	/// @param scale temporarily override the scale
 	void show(uint8_t scale);
@@ -484,6 +573,22 @@ public:
 	/// Update all our controllers with the current led colors
 	void show() { show(m_Scale); }
 
+	/// Like show, but returns as soon as every controller was handed its frame, leaving controllers that can
+	/// write out in the background (esp32 rmt, octows2811) to do so while the next frame gets rendered.  The
+	/// led data may be changed right away.  Controllers without background output finish writing before
+	/// this returns, just like with show.
+	/// @param scale temporarily override the scale
+	void showAsync(uint8_t scale);
+
+	/// Like show, but doesn't wait for controllers writing out in the background to finish
+	void showAsync() { showAsync(m_Scale); }
+
+	/// check if any controller is still writing out a frame in the background
+	bool isBusy();
+
+	/// wait until all controllers finished writing out their frames
+	void waitForShow();
+
 	/// clear the leds, wiping the local array of data, optionally black out the leds as well
 	/// @param writeData whether or not to write out to the leds as well
 	void clear(bool writeData = false);
@@ -518,7 +623,7 @@ public:
 
 	/// Set the dithering mode.  Sets the dithering mode for all added led strips, overriding
 	/// whatever previous dithering option those controllers may have had.
-	/// @param ditherMode - what type of dithering to use, either BINARY_DITHER or DISABLE_DITHER
+	/// @param ditherMode - what type of dithering to use, BINARY_DITHER, BAYER_DITHER or DISABLE_DITHER
 	void setDither(uint8_t ditherMode = BINARY_DITHER);
 
 	/// Set the maximum refresh rate.  This is global for all leds.  Attempts to
@@ -530,6 +635,18 @@ public:
 	/// @param constrain - constrain refresh rate to the slowest speed yet set
 	void setMaxRefreshRate(uint16_t refresh, bool constrain=false);
 
+	/// Set a function to call while show is waiting for the next frame slot, e.g. to render ahead or
+	/// service other work.  It gets called repeatedly with the time left until the slot starts, so it
+	/// should return well within that time to keep the frame rate steady.  Without one, yield() is
+	/// called instead.
+	/// @param func - function to call while waiting, NULL to just yield
+	void setIdleFunction(idle_func func) { m_pIdleFunc = func; }
+
+	/// Get the time left until the next frame can be shown without waiting, 0 if it can be shown now.
+	/// Frames are kept on a fixed grid of 1/refresh rate intervals for as long as show keeps up with it.
+	/// @returns the number of microseconds until the next frame slot
+	uint32_t getMicrosUntilNextFrame();
+
 	/// for debugging, will keep track of time between calls to countFPS, and every
 	/// nFrames calls, it will update an internal counter for the current FPS.
 	/// @todo make this a rolling counter
@@ -540,6 +657,27 @@ public:
 	/// @returns the most recently computed FPS value
 	uint16_t getFPS() { return m_nFPS; }
 
+#if FASTLED_PROFILE == 1
+	/// @name Frame profiler
+	/// Timing statistics for the stages of show() and showColor(), in µs.  Only available
+	/// when FASTLED_PROFILE is set to 1, see fastled_config.h.  Per controller output times
+	/// are available through CLEDController::getShowStats().
+	//@{
+	/// time spent waiting to honor the max refresh rate
+	CTimingStats & getWaitStats() { return m_WaitStats; }
+	/// how late frames started after the start of their frame slot (i.e. the frame pacing jitter)
+	CTimingStats & getLateStats() { return m_LateStats; }
+	/// number of frames that missed their deadline, i.e. that were shown after their frame slot had begun
+	uint32_t getMissedFrames() { return m_nMissedFrames; }
+	/// time spent in the power limiting function
+	CTimingStats & getPowerStats() { return m_PowerStats; }
+	/// time spent writing out the data of all controllers
+	CTimingStats & getShowStats() { return m_ShowStats; }
+	/// reset all frame statistics, including those of the controllers
+	void resetStats();
+	//@}
+#endif
+
 	/// Get how many controllers have been registered
   /// @returns the number of controllers (strips) that have been added with addLeds
 	int count();
@@ -48,6 +48,7 @@ protected:
 			Serial.write(b);
 			pixels.advanceData();
 			pixels.stepDithering();
+			pixels.stepBayerDithering();
 		}
 		mWait.mark();
 	}
@@ -99,6 +100,8 @@ public:
 		mSPI.init();
 	}
 
+	virtual bool canTruncateFrames() const { return true; }
+
 protected:
 
 	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
@@ -131,6 +134,8 @@ public:
 	  mWaitDelay.mark();
 	}
 
+	virtual bool canTruncateFrames() const { return true; }
+
 protected:
 
 	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
@@ -184,6 +189,9 @@ public:
 		mSPI.init();
 	}
 
+	// no canTruncateFrames here - the 0xFF end frame would be latched as a full brightness black led by the
+	// first led past a truncated write
+
 protected:
 
 	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
@@ -204,6 +212,7 @@ protected:
 		while (pixels.has(1)) {
 			writeLed(brightness, pixels.loadAndScale0(0, s0), pixels.loadAndScale1(0, s1), pixels.loadAndScale2(0, s2));
 			pixels.stepDithering();
+			pixels.stepBayerDithering();
 			pixels.advanceData();
 		}
 		endBoundary(pixels.size());
@@ -249,6 +258,8 @@ public:
 		mSPI.init();
 	}
 
+	virtual bool canTruncateFrames() const { return true; }
+
 protected:
 
 	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
@@ -269,6 +280,7 @@ protected:
 		while (pixels.has(1)) {
 			writeLed(brightness, pixels.loadAndScale0(0, s0), pixels.loadAndScale1(0, s1), pixels.loadAndScale2(0, s2));
 			pixels.stepDithering();
+			pixels.stepBayerDithering();
 			pixels.advanceData();
 		}
 		endBoundary(pixels.size());
@@ -321,6 +333,7 @@ protected:
 			writeLed(pixels.loadAndScale0(), pixels.loadAndScale1(), pixels.loadAndScale2());
 			pixels.advanceData();
 			pixels.stepDithering();
+			pixels.stepBayerDithering();
 		}
 		writeBoundary();
 		mSPI.waitFully();
@@ -6,6 +6,24 @@
 
 #include "FastLED.h"
 
+// Pick an implementation for looking up runs of palette colors
+#if (FASTLED_SCALE8_FIXED != 1) || defined(__AVR__)
+#define PALETTE_RUNS_C 1
+#elif defined(__AVX2__)
+#define PALETTE_RUNS_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#define PALETTE_RUNS_SSSE3 1
+#include <tmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define PALETTE_RUNS_NEON 1
+#include <arm_neon.h>
+#else
+// anything with 32 bit registers, e.g. the Cortex M4 or ESP32, does two
+// channels to a multiply
+#define PALETTE_RUNS_X2 1
+#endif
+
 FASTLED_NAMESPACE_BEGIN
 
 
@@ -26,6 +44,14 @@ void fill_solid( struct CHSV * targetArray, int numToFill,
     }
 }
 
+void fill_solid( struct CRGB16 * leds, int numToFill,
+                 const struct CRGB16& color)
+{
+    for( int i = 0; i < numToFill; i++) {
+        leds[i] = color;
+    }
+}
+
 
 // void fill_solid( struct CRGB* targetArray, int numToFill,
 // 				 const struct CHSV& hsvColor)
@@ -37,11 +63,22 @@ void fill_rainbow( struct CRGB * pFirstLED, int numToFill,
                   uint8_t initialhue,
                   uint8_t deltahue )
 {
+#if FASTLED_HUE_TABLE != 0
+    // at full saturation, hsv2rgb_rainbow comes down to the hue's color
+    // scaled by the value
+    const uint8_t scale = dim8_raw( 240);
+    uint8_t hue = initialhue;
+    for( int i = 0; i < numToFill; i++) {
+        pFirstLED[i] = hue2rgb_wheel( hue).nscale8( scale);
+        hue += deltahue;
+    }
+#else
     CHSV hsv( initialhue, 255, 240);
     for( int i = 0; i < numToFill; i++) {
         pFirstLED[i] = hsv;
         hsv.hue += deltahue;
     }
+#endif
 }
 NO_INLINE
 void fill_rainbow( struct CHSV * targetArray, int numToFill,
@@ -203,6 +240,13 @@ void nscale8( CRGB* leds, uint16_t num_leds, uint8_t scale)
     }
 }
 
+void nscale16( CRGB16* leds, uint16_t num_leds, fract16 scale)
+{
+    for( uint16_t i = 0; i < num_leds; i++) {
+        leds[i].nscale16( scale);
+    }
+}
+
 void fadeUsingColor( CRGB* leds, uint16_t numLeds, const CRGB& colormask)
 {
     uint8_t fr, fg, fb;
@@ -277,6 +321,40 @@ CRGB* blend( const CRGB* src1, const CRGB* src2, CRGB* dest, uint16_t count, fra
     return dest;
 }
 
+CRGB16& nblend( CRGB16& existing, const CRGB16& overlay, fract16 amountOfOverlay )
+{
+    if( amountOfOverlay == 0) {
+        return existing;
+    }
+
+    if( amountOfOverlay == 0xFFFF) {
+        existing = overlay;
+        return existing;
+    }
+
+    existing.red   = lerp16by16( existing.red,   overlay.red,   amountOfOverlay);
+    existing.green = lerp16by16( existing.green, overlay.green, amountOfOverlay);
+    existing.blue  = lerp16by16( existing.blue,  overlay.blue,  amountOfOverlay);
+
+    return existing;
+}
+
+void nblend( CRGB16* existing, CRGB16* overlay, uint16_t count, fract16 amountOfOverlay)
+{
+    for( uint16_t i = count; i; i--) {
+        nblend( *existing, *overlay, amountOfOverlay);
+        existing++;
+        overlay++;
+    }
+}
+
+CRGB16 blend( const CRGB16& p1, const CRGB16& p2, fract16 amountOfP2 )
+{
+    CRGB16 nu(p1);
+    nblend( nu, p2, amountOfP2);
+    return nu;
+}
+
 
 
 CHSV& nblend( CHSV& existing, const CHSV& overlay, fract8 amountOfOverlay, TGradientDirectionCode directionCode)
@@ -857,6 +935,402 @@ CRGB ColorFromPalette( const CRGBPalette256& pal, uint8_t index, uint8_t brightn
 }
 
 
+// Looking up runs of palette colors at a time, for fill_palette and
+// map_data_into_colors_through_palette.  These give exactly what
+// ColorFromPalette does for each led, with the per led branching on the
+// blend and brightness folded into two multipliers: blending scales the
+// first entry by 256-f2 and the second by f2+1, and brightness scales
+// the result by brightness+2 (or 256 at full brightness, 0 when off).
+// That only holds with the 'fixed' scale8, otherwise it's one led at a
+// time through ColorFromPalette.
+
+#if PALETTE_RUNS_C != 1
+// scale the two channels sitting in the low bytes of the two halves of x
+#define SCALE8X2(x, s) ((((x) * (s)) >> 8) & 0x00FF00FF)
+
+// one led, two channels to a 32 bit multiply: red and blue share one,
+// green gets the other
+static inline CRGB palette_color_x2( const CRGB& e1, const CRGB& e2, uint16_t f2, uint16_t bscale)
+{
+    const uint16_t m1 = 256 - f2;
+    const uint16_t m2 = f2 + 1;
+    uint32_t rb = SCALE8X2( e1.r | ((uint32_t)e1.b << 16), m1) + SCALE8X2( e2.r | ((uint32_t)e2.b << 16), m2);
+    uint32_t g = (((uint32_t)e1.g * m1) >> 8) + (((uint32_t)e2.g * m2) >> 8);
+    rb = SCALE8X2( rb, bscale);
+    g = (g * bscale) >> 8;
+    return CRGB( rb, g, rb >> 16);
+}
+
+#if (PALETTE_RUNS_SSSE3 == 1) || (PALETTE_RUNS_AVX2 == 1)
+// the byte table lookups are shuffles, which only go 16 entries deep; the
+// 32 entry palettes get looked up in each half, with the lanes belonging
+// to the other half zeroed out by setting the top bit of their index
+#if PALETTE_RUNS_AVX2 == 1
+#define PAL_LANES 32
+typedef __m256i pal_vec;
+#define PAL_TABLE(p)      _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(p)))
+#define PAL_LOAD(p)       _mm256_loadu_si256((const __m256i*)(p))
+#define PAL_SET8(x)       _mm256_set1_epi8((char)(x))
+#define PAL_SET16(x)      _mm256_set1_epi16(x)
+#define PAL_ZERO()        _mm256_setzero_si256()
+#define PAL_SHUFFLE(t,i)  _mm256_shuffle_epi8(t,i)
+#define PAL_AND(a,b)      _mm256_and_si256(a,b)
+#define PAL_OR(a,b)       _mm256_or_si256(a,b)
+#define PAL_XOR(a,b)      _mm256_xor_si256(a,b)
+#define PAL_ADD16(a,b)    _mm256_add_epi16(a,b)
+#define PAL_SUB16(a,b)    _mm256_sub_epi16(a,b)
+#define PAL_MUL16(a,b)    _mm256_mullo_epi16(a,b)
+#define PAL_SHL16(a,n)    _mm256_slli_epi16(a,n)
+#define PAL_SHR16(a,n)    _mm256_srli_epi16(a,n)
+#define PAL_UNPACKLO(a,b) _mm256_unpacklo_epi8(a,b)
+#define PAL_UNPACKHI(a,b) _mm256_unpackhi_epi8(a,b)
+#define PAL_PACK(a,b)     _mm256_packus_epi16(a,b)
+#else
+#define PAL_LANES 16
+typedef __m128i pal_vec;
+#define PAL_TABLE(p)      _mm_loadu_si128((const __m128i*)(p))
+#define PAL_LOAD(p)       _mm_loadu_si128((const __m128i*)(p))
+#define PAL_SET8(x)       _mm_set1_epi8((char)(x))
+#define PAL_SET16(x)      _mm_set1_epi16(x)
+#define PAL_ZERO()        _mm_setzero_si128()
+#define PAL_SHUFFLE(t,i)  _mm_shuffle_epi8(t,i)
+#define PAL_AND(a,b)      _mm_and_si128(a,b)
+#define PAL_OR(a,b)       _mm_or_si128(a,b)
+#define PAL_XOR(a,b)      _mm_xor_si128(a,b)
+#define PAL_ADD16(a,b)    _mm_add_epi16(a,b)
+#define PAL_SUB16(a,b)    _mm_sub_epi16(a,b)
+#define PAL_MUL16(a,b)    _mm_mullo_epi16(a,b)
+#define PAL_SHL16(a,n)    _mm_slli_epi16(a,n)
+#define PAL_SHR16(a,n)    _mm_srli_epi16(a,n)
+#define PAL_UNPACKLO(a,b) _mm_unpacklo_epi8(a,b)
+#define PAL_UNPACKHI(a,b) _mm_unpackhi_epi8(a,b)
+#define PAL_PACK(a,b)     _mm_packus_epi16(a,b)
+#endif
+
+// shuffles putting 16 leds' worth of r, g and b bytes back together into
+// three 16 byte blocks of CRGBs, -1 leaves a byte for the other channels
+static const int8_t gRGBInterleave[3][3][16] = {
+    { {  0, -1, -1,  1, -1, -1,  2, -1, -1,  3, -1, -1,  4, -1, -1,  5 },     // bytes 0..15
+      { -1,  0, -1, -1,  1, -1, -1,  2, -1, -1,  3, -1, -1,  4, -1, -1 },
+      { -1, -1,  0, -1, -1,  1, -1, -1,  2, -1, -1,  3, -1, -1,  4, -1 } },
+    { { -1, -1,  6, -1, -1,  7, -1, -1,  8, -1, -1,  9, -1, -1, 10, -1 },     // bytes 16..31
+      {  5, -1, -1,  6, -1, -1,  7, -1, -1,  8, -1, -1,  9, -1, -1, 10 },
+      { -1,  5, -1, -1,  6, -1, -1,  7, -1, -1,  8, -1, -1,  9, -1, -1 } },
+    { { -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1 },     // bytes 32..47
+      { -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1 },
+      { 10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15 } }
+};
+
+static inline void palette_store_rgb16( __m128i r, __m128i g, __m128i b, CRGB* out)
+{
+    for( uint8_t q = 0; q < 3; q++) {
+        const __m128i x = _mm_or_si128( _mm_or_si128(
+            _mm_shuffle_epi8( r, _mm_loadu_si128((const __m128i*)gRGBInterleave[q][0])),
+            _mm_shuffle_epi8( g, _mm_loadu_si128((const __m128i*)gRGBInterleave[q][1]))),
+            _mm_shuffle_epi8( b, _mm_loadu_si128((const __m128i*)gRGBInterleave[q][2])));
+        _mm_storeu_si128((__m128i*)((uint8_t*)out + (q * 16)), x);
+    }
+}
+
+static inline void palette_store_rgb( pal_vec r, pal_vec g, pal_vec b, CRGB* out)
+{
+#if PALETTE_RUNS_AVX2 == 1
+    palette_store_rgb16( _mm256_castsi256_si128( r), _mm256_castsi256_si128( g), _mm256_castsi256_si128( b), out);
+    palette_store_rgb16( _mm256_extracti128_si256( r, 1), _mm256_extracti128_si256( g, 1), _mm256_extracti128_si256( b, 1), out + 16);
+#else
+    palette_store_rgb16( r, g, b, out);
+#endif
+}
+
+// blend c1 and c2 by m1 and m2, then scale by bscale, in two halves of 16 bit lanes
+static inline pal_vec palette_lerp_lanes( pal_vec c1, pal_vec c2, const pal_vec m1[2], const pal_vec m2[2], pal_vec bscale)
+{
+    const pal_vec zero = PAL_ZERO();
+    pal_vec lo = PAL_ADD16( PAL_SHR16( PAL_MUL16( PAL_UNPACKLO( c1, zero), m1[0]), 8),
+                            PAL_SHR16( PAL_MUL16( PAL_UNPACKLO( c2, zero), m2[0]), 8));
+    pal_vec hi = PAL_ADD16( PAL_SHR16( PAL_MUL16( PAL_UNPACKHI( c1, zero), m1[1]), 8),
+                            PAL_SHR16( PAL_MUL16( PAL_UNPACKHI( c2, zero), m2[1]), 8));
+    lo = PAL_SHR16( PAL_MUL16( lo, bscale), 8);
+    hi = PAL_SHR16( PAL_MUL16( hi, bscale), 8);
+    return PAL_PACK( lo, hi);
+}
+
+template <uint8_t SIZE_BITS>
+static uint8_t palette_run_lanes( const uint8_t tables[6][32], const uint8_t* idx, uint8_t n,
+                                  uint8_t f2mask, uint16_t bscale, CRGB* out)
+{
+    pal_vec t[6][2];
+    for( uint8_t c = 0; c < 6; c++) {
+        t[c][0] = PAL_TABLE( tables[c]);
+        t[c][1] = PAL_TABLE( tables[c] + 16);
+    }
+    const pal_vec zero = PAL_ZERO();
+    const pal_vec top = PAL_SET8( 0x80);
+    const pal_vec one = PAL_SET16( 1);
+    const pal_vec full = PAL_SET16( 256);
+    const pal_vec bs = PAL_SET16( bscale);
+
+    uint8_t i = 0;
+    for( ; i + PAL_LANES <= n; i += PAL_LANES) {
+        const pal_vec index = PAL_LOAD( idx + i);
+        const pal_vec hi = PAL_AND( PAL_SHR16( index, 8 - SIZE_BITS), PAL_SET8( 0xFF >> (8 - SIZE_BITS)));
+        const pal_vec f2 = PAL_AND( PAL_SHL16( index, SIZE_BITS), PAL_SET8( f2mask));
+        pal_vec m1[2], m2[2];
+        m1[0] = PAL_SUB16( full, PAL_UNPACKLO( f2, zero));
+        m1[1] = PAL_SUB16( full, PAL_UNPACKHI( f2, zero));
+        m2[0] = PAL_ADD16( PAL_UNPACKLO( f2, zero), one);
+        m2[1] = PAL_ADD16( PAL_UNPACKHI( f2, zero), one);
+
+        // 0x80 in the lanes looking up the second half of a 32 entry palette
+        const pal_vec upper = (SIZE_BITS == 5) ? PAL_SHL16( PAL_AND( hi, PAL_SET8( 0x10)), 3) : zero;
+        const pal_vec inLower = PAL_OR( hi, upper);
+        const pal_vec inUpper = PAL_OR( hi, PAL_XOR( upper, top));
+
+        pal_vec rgb[3];
+        for( uint8_t c = 0; c < 3; c++) {
+            pal_vec c1 = PAL_SHUFFLE( t[c][0], inLower);
+            pal_vec c2 = PAL_SHUFFLE( t[c + 3][0], inLower);
+            if( SIZE_BITS == 5) {
+                c1 = PAL_OR( c1, PAL_SHUFFLE( t[c][1], inUpper));
+                c2 = PAL_OR( c2, PAL_SHUFFLE( t[c + 3][1], inUpper));
+            }
+            rgb[c] = palette_lerp_lanes( c1, c2, m1, m2, bs);
+        }
+        palette_store_rgb( rgb[0], rgb[1], rgb[2], out + i);
+    }
+    return i;
+}
+#elif PALETTE_RUNS_NEON == 1
+// 16 leds at a time, tbl looks up all 32 entries at once and vst3 puts
+// the channels back together
+template <uint8_t SIZE_BITS>
+static uint8_t palette_run_lanes( const uint8_t tables[6][32], const uint8_t* idx, uint8_t n,
+                                  uint8_t f2mask, uint16_t bscale, CRGB* out)
+{
+    uint8x16x2_t t[6];
+    for( uint8_t c = 0; c < 6; c++) {
+        t[c].val[0] = vld1q_u8( tables[c]);
+        t[c].val[1] = vld1q_u8( tables[c] + 16);
+    }
+    const uint16x8_t one = vdupq_n_u16( 1);
+    const uint16x8_t full = vdupq_n_u16( 256);
+    const uint16x8_t bs = vdupq_n_u16( bscale);
+
+    uint8_t i = 0;
+    for( ; i + 16 <= n; i += 16) {
+        const uint8x16_t index = vld1q_u8( idx + i);
+        const uint8x16_t hi = vshrq_n_u8( index, 8 - SIZE_BITS);
+        const uint8x16_t f2 = vandq_u8( vshlq_n_u8( index, SIZE_BITS), vdupq_n_u8( f2mask));
+        const uint16x8_t f2lo = vmovl_u8( vget_low_u8( f2));
+        const uint16x8_t f2hi = vmovl_u8( vget_high_u8( f2));
+        const uint16x8_t m1lo = vsubq_u16( full, f2lo), m1hi = vsubq_u16( full, f2hi);
+        const uint16x8_t m2lo = vaddq_u16( f2lo, one), m2hi = vaddq_u16( f2hi, one);
+
+        uint8x16x3_t rgb;
+        for( uint8_t c = 0; c < 3; c++) {
+            const uint8x16_t c1 = vqtbl2q_u8( t[c], hi);
+            const uint8x16_t c2 = vqtbl2q_u8( t[c + 3], hi);
+            uint16x8_t lo = vaddq_u16( vshrq_n_u16( vmulq_u16( vmovl_u8( vget_low_u8( c1)), m1lo), 8),
+                                       vshrq_n_u16( vmulq_u16( vmovl_u8( vget_low_u8( c2)), m2lo), 8));
+            uint16x8_t hi16 = vaddq_u16( vshrq_n_u16( vmulq_u16( vmovl_u8( vget_high_u8( c1)), m1hi), 8),
+                                         vshrq_n_u16( vmulq_u16( vmovl_u8( vget_high_u8( c2)), m2hi), 8));
+            lo = vshrq_n_u16( vmulq_u16( lo, bs), 8);
+            hi16 = vshrq_n_u16( vmulq_u16( hi16, bs), 8);
+            rgb.val[c] = vcombine_u8( vmovn_u16( lo), vmovn_u16( hi16));
+        }
+        vst3q_u8( (uint8_t*)(out + i), rgb);
+    }
+    return i;
+}
+#endif
+
+// the brightness multiplier, see above
+static inline uint16_t palette_bscale( uint8_t brightness)
+{
+    if( brightness == 255) return 256;
+    if( brightness == 0) return 0;
+    return brightness + 2;
+}
+
+// the colors of the n leds at idx in a 16 or 32 entry palette; sizeBits
+// is 4 or 5
+static void palette_run( const CRGB* entries, uint8_t sizeBits, const uint8_t* idx, uint8_t n,
+                         uint8_t brightness, TBlendType blendType, CRGB* out)
+{
+    const uint8_t lastEntry = (1 << sizeBits) - 1;
+    const uint8_t f2mask = (blendType == NOBLEND) ? 0 : (0xFF << sizeBits);
+    const uint16_t bscale = palette_bscale( brightness);
+    uint8_t i = 0;
+
+#if (PALETTE_RUNS_SSSE3 == 1) || (PALETTE_RUNS_AVX2 == 1) || (PALETTE_RUNS_NEON == 1)
+    // the channels of the entries, and of the entries after them, laid out
+    // as byte tables for shuffles to look up 16 (or 32) leds at once
+    uint8_t tables[6][32];
+    for( uint8_t e = 0; e < 32; e++) {
+        const CRGB& e1 = entries[e & lastEntry];
+        const CRGB& e2 = entries[(e + 1) & lastEntry];
+        tables[0][e] = e1.r; tables[1][e] = e1.g; tables[2][e] = e1.b;
+        tables[3][e] = e2.r; tables[4][e] = e2.g; tables[5][e] = e2.b;
+    }
+    if( sizeBits == 4) {
+        i = palette_run_lanes<4>( tables, idx, n, f2mask, bscale, out);
+    } else {
+        i = palette_run_lanes<5>( tables, idx, n, f2mask, bscale, out);
+    }
+#endif
+
+    for( ; i < n; i++) {
+        const uint8_t index = idx[i];
+        const uint8_t hi = index >> (8 - sizeBits);
+        out[i] = palette_color_x2( entries[hi], entries[(hi + 1) & lastEntry],
+                                   (uint8_t)(index << sizeBits) & f2mask, bscale);
+    }
+}
+
+// the colors of the n leds at idx in a 256 entry palette, scaled like
+// ColorFromPalette( CRGBPalette256) does, i.e. with scale8_video
+static void palette_run( const CRGBPalette256& pal, const uint8_t* idx, uint8_t n, uint8_t brightness, CRGB* out)
+{
+    const CRGB* entries = &(pal[0]);
+    if( brightness == 255) {
+        for( uint8_t i = 0; i < n; i++) { out[i] = entries[idx[i]]; }
+        return;
+    }
+    const uint16_t scale = brightness + 1;
+    for( uint8_t i = 0; i < n; i++) {
+        const CRGB& e = entries[idx[i]];
+        uint32_t rb = e.r | ((uint32_t)e.b << 16);
+        uint32_t g = e.g;
+        // scale8_video adds one to anything that isn't zero
+        rb = SCALE8X2( rb, scale) + (((rb + 0x00FF00FF) >> 8) & 0x00010001);
+        g = ((g * scale) >> 8) + (g != 0);
+        out[i] = CRGB( rb, g, rb >> 16);
+    }
+}
+#endif
+
+// how many leds get looked up at a time, on the stack
+#if defined(__AVR__)
+#define PALETTE_RUN 8
+#else
+#define PALETTE_RUN 32
+#endif
+
+template <typename PALETTE>
+static inline void palette_run_any( const PALETTE& pal, const uint8_t* idx, uint8_t n,
+                                    uint8_t brightness, TBlendType blendType, CRGB* out)
+{
+    for( uint8_t i = 0; i < n; i++) {
+        out[i] = ColorFromPalette( pal, idx[i], brightness, blendType);
+    }
+}
+
+#if PALETTE_RUNS_C != 1
+static inline void palette_run_any( const CRGBPalette16& pal, const uint8_t* idx, uint8_t n,
+                                    uint8_t brightness, TBlendType blendType, CRGB* out)
+{
+    palette_run( &(pal[0]), 4, idx, n, brightness, blendType, out);
+}
+
+static inline void palette_run_any( const CRGBPalette32& pal, const uint8_t* idx, uint8_t n,
+                                    uint8_t brightness, TBlendType blendType, CRGB* out)
+{
+    palette_run( &(pal[0]), 5, idx, n, brightness, blendType, out);
+}
+
+static inline void palette_run_any( const CRGBPalette256& pal, const uint8_t* idx, uint8_t n,
+                                    uint8_t brightness, TBlendType, CRGB* out)
+{
+    palette_run( pal, idx, n, brightness, out);
+}
+#endif
+
+template <typename PALETTE>
+static void fill_palette_runs( CRGB* L, uint16_t N, uint8_t startIndex, uint8_t incIndex,
+                               const PALETTE& pal, uint8_t brightness, TBlendType blendType)
+{
+    uint8_t idx[PALETTE_RUN];
+    uint8_t colorIndex = startIndex;
+    while( N) {
+        const uint8_t n = (N < PALETTE_RUN) ? N : PALETTE_RUN;
+        for( uint8_t i = 0; i < n; i++) {
+            idx[i] = colorIndex;
+            colorIndex += incIndex;
+        }
+        palette_run_any( pal, idx, n, brightness, blendType, L);
+        L += n;
+        N -= n;
+    }
+}
+
+template <typename PALETTE>
+static void map_data_runs( uint8_t *dataArray, uint16_t dataCount, CRGB* targetColorArray,
+                           const PALETTE& pal, uint8_t brightness, uint8_t opacity, TBlendType blendType)
+{
+    // nothing to blend in - and 256 - opacity would wrap around to a scale of 0, clearing the leds
+    if( opacity == 0 ) {
+        return;
+    }
+    CRGB colors[PALETTE_RUN];
+    while( dataCount) {
+        const uint8_t n = (dataCount < PALETTE_RUN) ? dataCount : PALETTE_RUN;
+        if( opacity == 255 ) {
+            palette_run_any( pal, dataArray, n, brightness, blendType, targetColorArray);
+        } else {
+            palette_run_any( pal, dataArray, n, brightness, blendType, colors);
+            for( uint8_t i = 0; i < n; i++) {
+                CRGB rgb = colors[i];
+                targetColorArray[i].nscale8( 256 - opacity);
+                rgb.nscale8_video( opacity);
+                targetColorArray[i] += rgb;
+            }
+        }
+        dataArray += n;
+        targetColorArray += n;
+        dataCount -= n;
+    }
+}
+
+void fill_palette(CRGB* L, uint16_t N, uint8_t startIndex, uint8_t incIndex,
+                  const CRGBPalette16& pal, uint8_t brightness, TBlendType blendType)
+{
+    fill_palette_runs( L, N, startIndex, incIndex, pal, brightness, blendType);
+}
+
+void fill_palette(CRGB* L, uint16_t N, uint8_t startIndex, uint8_t incIndex,
+                  const CRGBPalette32& pal, uint8_t brightness, TBlendType blendType)
+{
+    fill_palette_runs( L, N, startIndex, incIndex, pal, brightness, blendType);
+}
+
+void fill_palette(CRGB* L, uint16_t N, uint8_t startIndex, uint8_t incIndex,
+                  const CRGBPalette256& pal, uint8_t brightness, TBlendType blendType)
+{
+    fill_palette_runs( L, N, startIndex, incIndex, pal, brightness, blendType);
+}
+
+void map_data_into_colors_through_palette( uint8_t *dataArray, uint16_t dataCount, CRGB* targetColorArray,
+                                           const CRGBPalette16& pal, uint8_t brightness, uint8_t opacity,
+                                           TBlendType blendType)
+{
+    map_data_runs( dataArray, dataCount, targetColorArray, pal, brightness, opacity, blendType);
+}
+
+void map_data_into_colors_through_palette( uint8_t *dataArray, uint16_t dataCount, CRGB* targetColorArray,
+                                           const CRGBPalette32& pal, uint8_t brightness, uint8_t opacity,
+                                           TBlendType blendType)
+{
+    map_data_runs( dataArray, dataCount, targetColorArray, pal, brightness, opacity, blendType);
+}
+
+void map_data_into_colors_through_palette( uint8_t *dataArray, uint16_t dataCount, CRGB* targetColorArray,
+                                           const CRGBPalette256& pal, uint8_t brightness, uint8_t opacity,
+                                           TBlendType blendType)
+{
+    map_data_runs( dataArray, dataCount, targetColorArray, pal, brightness, opacity, blendType);
+}
+
+
 CHSV ColorFromPalette( const struct CHSVPalette16& pal, uint8_t index, uint8_t brightness, TBlendType blendType)
 {
     //      hi4 = index >> 4;
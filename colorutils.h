@@ -20,6 +20,11 @@ void fill_solid( struct CRGB * leds, int numToFill,
 
 /// fill_solid -   fill a range of LEDs with a solid color
 ///                Example: fill_solid( leds, NUM_LEDS, CRGB(50,0,200));
+
+/// fill_solid -   fill a range of 16 bit LEDs with a solid color
+///                Example: fill_solid( leds16, NUM_LEDS, CRGB16(50,0,20000));
+void fill_solid( struct CRGB16 * leds, int numToFill,
+                 const struct CRGB16& color);
 void fill_solid( struct CHSV* targetArray, int numToFill,
 				 const struct CHSV& hsvColor);
 
@@ -253,6 +258,10 @@ void fade_raw(      CRGB* leds, uint16_t num_leds, uint8_t fadeBy);
 //           way down to black even if 'scale' is not zero.
 void nscale8(       CRGB* leds, uint16_t num_leds, uint8_t scale);
 
+// nscale16 - scale down the brightness of an array of 16 bit pixels
+//            by N 65536ths of its current brightness
+void nscale16(      CRGB16* leds, uint16_t num_leds, fract16 scale);
+
 // fadeUsingColor - scale down the brightness of an array of pixels,
 //                  as though it were seen through a transparent
 //                  filter with the specified color.
@@ -274,6 +283,8 @@ void fadeUsingColor( CRGB* leds, uint16_t numLeds, const CRGB& colormask);
 //         between two other colors.
 CRGB  blend( const CRGB& p1, const CRGB& p2, fract8 amountOfP2 );
 
+CRGB16 blend( const CRGB16& p1, const CRGB16& p2, fract16 amountOfP2 );
+
 CHSV  blend( const CHSV& p1, const CHSV& p2, fract8 amountOfP2,
             TGradientDirectionCode directionCode = SHORTEST_HUES );
 
@@ -292,6 +303,8 @@ CHSV* blend( const CHSV* src1, const CHSV* src2, CHSV* dest,
 //          in a given fraction of an overlay color
 CRGB& nblend( CRGB& existing, const CRGB& overlay, fract8 amountOfOverlay );
 
+CRGB16& nblend( CRGB16& existing, const CRGB16& overlay, fract16 amountOfOverlay );
+
 CHSV& nblend( CHSV& existing, const CHSV& overlay, fract8 amountOfOverlay,
              TGradientDirectionCode directionCode = SHORTEST_HUES );
 
@@ -299,6 +312,8 @@ CHSV& nblend( CHSV& existing, const CHSV& overlay, fract8 amountOfOverlay,
 //          a new color array into an existing color array
 void  nblend( CRGB* existing, CRGB* overlay, uint16_t count, fract8 amountOfOverlay);
 
+void  nblend( CRGB16* existing, CRGB16* overlay, uint16_t count, fract16 amountOfOverlay);
+
 void  nblend( CHSV* existing, CHSV* overlay, uint16_t count, fract8 amountOfOverlay,
              TGradientDirectionCode directionCode = SHORTEST_HUES);
 
@@ -403,6 +418,7 @@ typedef uint32_t TProgmemHSVPalette16[16];
 typedef uint32_t TProgmemRGBPalette32[32];
 typedef uint32_t TProgmemHSVPalette32[32];
 #define TProgmemPalette32 TProgmemRGBPalette32
+typedef uint32_t TProgmemRGBPalette256[256];
 
 typedef const uint8_t TProgmemRGBGradientPalette_byte ;
 typedef const TProgmemRGBGradientPalette_byte *TProgmemRGBGradientPalette_bytes;
@@ -1388,6 +1404,18 @@ public:
         return *this;
     }
 
+    CRGBPalette256( const TProgmemRGBPalette256& rhs)
+    {
+        *this = rhs;
+    }
+    CRGBPalette256& operator=( const TProgmemRGBPalette256& rhs)
+    {
+        for( uint16_t i = 0; i < 256; i++) {
+            entries[i] =  FL_PGM_READ_DWORD_NEAR( rhs + i);
+        }
+        return *this;
+    }
+
     bool operator==( const CRGBPalette256 rhs)
     {
         const uint8_t* p = (const uint8_t*)(&(this->entries[0]));
@@ -1572,19 +1600,153 @@ void map_data_into_colors_through_palette(
 	uint8_t opacity=255,
 	TBlendType blendType=LINEARBLEND)
 {
+	// nothing to blend in - and 256 - opacity would wrap around to a scale of 0, clearing the leds
+	if( opacity == 0 ) {
+		return;
+	}
 	for( uint16_t i = 0; i < dataCount; i++) {
 		uint8_t d = dataArray[i];
 		CRGB rgb = ColorFromPalette( pal, d, brightness, blendType);
 		if( opacity == 255 ) {
 			targetColorArray[i] = rgb;
 		} else {
-			targetColorArray[i].nscale8( 256 - opacity);    // TODO: overflow for opacity == 0 ????
+			targetColorArray[i].nscale8( 256 - opacity);
 			rgb.nscale8_video( opacity);
 			targetColorArray[i] += rgb;
 		}
 	}
 }
 
+// fill_palette and map_data_into_colors_through_palette for the RGB palette
+// classes look up runs of leds at a time, with SIMD instructions where the
+// target has them, and give exactly the same colors as ColorFromPalette.
+void fill_palette(CRGB* L, uint16_t N, uint8_t startIndex, uint8_t incIndex,
+                  const CRGBPalette16& pal, uint8_t brightness, TBlendType blendType);
+void fill_palette(CRGB* L, uint16_t N, uint8_t startIndex, uint8_t incIndex,
+                  const CRGBPalette32& pal, uint8_t brightness, TBlendType blendType);
+void fill_palette(CRGB* L, uint16_t N, uint8_t startIndex, uint8_t incIndex,
+                  const CRGBPalette256& pal, uint8_t brightness, TBlendType blendType);
+
+void map_data_into_colors_through_palette(
+	uint8_t *dataArray, uint16_t dataCount,
+	CRGB* targetColorArray,
+	const CRGBPalette16& pal,
+	uint8_t brightness=255,
+	uint8_t opacity=255,
+	TBlendType blendType=LINEARBLEND);
+void map_data_into_colors_through_palette(
+	uint8_t *dataArray, uint16_t dataCount,
+	CRGB* targetColorArray,
+	const CRGBPalette32& pal,
+	uint8_t brightness=255,
+	uint8_t opacity=255,
+	TBlendType blendType=LINEARBLEND);
+void map_data_into_colors_through_palette(
+	uint8_t *dataArray, uint16_t dataCount,
+	CRGB* targetColorArray,
+	const CRGBPalette256& pal,
+	uint8_t brightness=255,
+	uint8_t opacity=255,
+	TBlendType blendType=LINEARBLEND);
+
+// CPaletteCache: a palette expanded out to all 256 colors, as they come out of
+//               ColorFromPalette for a given brightness and blend type,
+//               so that each color takes a single lookup.
+//
+//               The cache keeps a copy of the palette it was expanded from,
+//               and expands it again whenever the palette, the brightness
+//               or the blend type changed since the last time.  Checking
+//               for that is cheap next to looking up each led's color, but
+//               it's done per call to get(), not per led, so fetch the
+//               expansion once per frame (or let fill_palette and
+//               map_data_into_colors_through_palette do it) and index
+//               into that.
+//
+//               Works with CRGBPalette16 and CRGBPalette32, and takes
+//               768 bytes of RAM for the expansion plus the copy of the
+//               palette, e.g.
+//
+//                 CRGBPalette16 myPalette = RainbowColors_p;
+//                 CRGBPalette16Cache myCache( myPalette);
+//                 ...
+//                 fill_palette( leds, NUM_LEDS, startIndex, 3, myCache, brightness, LINEARBLEND);
+//
+template <typename PALETTE>
+class CPaletteCache {
+    const PALETTE& mSource;
+    PALETTE mExpandedFrom;
+    uint8_t mBrightness;
+    TBlendType mBlendType;
+    bool mValid;
+    CRGBPalette256 mExpanded;
+
+public:
+    CPaletteCache( const PALETTE& pal) : mSource(pal), mBrightness(255), mBlendType(LINEARBLEND), mValid(false) {}
+
+    /// the palette's 256 colors at the given brightness and blend type,
+    /// expanding it again first if anything changed
+    const CRGBPalette256& get( uint8_t brightness=255, TBlendType blendType=LINEARBLEND)
+    {
+        if( !mValid || brightness != mBrightness || blendType != mBlendType || mExpandedFrom != mSource) {
+            mExpandedFrom = mSource;
+            mBrightness = brightness;
+            mBlendType = blendType;
+            for( uint16_t i = 0; i < 256; i++) {
+                mExpanded[i] = ColorFromPalette( mExpandedFrom, i, brightness, blendType);
+            }
+            mValid = true;
+        }
+        return mExpanded;
+    }
+
+    /// force the next get() to expand the palette again
+    void invalidate() { mValid = false; }
+};
+
+typedef CPaletteCache<CRGBPalette16> CRGBPalette16Cache;
+typedef CPaletteCache<CRGBPalette32> CRGBPalette32Cache;
+
+// Fill a range of LEDs with a sequece of entries from a cached palette
+template <typename PALETTE>
+void fill_palette(CRGB* L, uint16_t N, uint8_t startIndex, uint8_t incIndex,
+                  CPaletteCache<PALETTE>& cache, uint8_t brightness, TBlendType blendType)
+{
+    const CRGB* colors = &(cache.get( brightness, blendType)[0]);
+    uint8_t colorIndex = startIndex;
+    for( uint16_t i = 0; i < N; i++) {
+        L[i] = colors[colorIndex];
+        colorIndex += incIndex;
+    }
+}
+
+template <typename PALETTE>
+void map_data_into_colors_through_palette(
+	uint8_t *dataArray, uint16_t dataCount,
+	CRGB* targetColorArray,
+	CPaletteCache<PALETTE>& cache,
+	uint8_t brightness=255,
+	uint8_t opacity=255,
+	TBlendType blendType=LINEARBLEND)
+{
+	// nothing to blend in - and 256 - opacity would wrap around to a scale of 0, clearing the leds
+	if( opacity == 0 ) {
+		return;
+	}
+	const CRGB* colors = &(cache.get( brightness, blendType)[0]);
+	if( opacity == 255 ) {
+		for( uint16_t i = 0; i < dataCount; i++) {
+			targetColorArray[i] = colors[dataArray[i]];
+		}
+		return;
+	}
+	for( uint16_t i = 0; i < dataCount; i++) {
+		CRGB rgb = colors[dataArray[i]];
+		targetColorArray[i].nscale8( 256 - opacity);
+		rgb.nscale8_video( opacity);
+		targetColorArray[i] += rgb;
+	}
+}
+
 // nblendPaletteTowardPalette:
 //               Alter one palette by making it slightly more like
 //               a 'target palette', used for palette cross-fades.
@@ -1666,15 +1828,119 @@ void nblendPaletteTowardPalette( CRGBPalette16& currentPalette,
 //    stored in PROGMEM on AVR-based Arduinos.  If you use the
 //    DEFINE_GRADIENT_PALETTE macro, this is taken care of automatically.
 //
-
+//  Assigning a gradient palette works out all the entries at runtime,
+//  every time.  If you switch between gradient palettes a lot, you can
+//  have them expanded when the sketch is compiled instead, into tables
+//  of 16, 32 or 256 colors kept in PROGMEM (flash), next to the
+//  gradient itself:
+//
+//    CRGBPalette16 pal = GRADIENT_PALETTE16( black_to_red_to_white_p );
+//    leds[i] = ColorFromPalette( GRADIENT_PALETTE32( black_to_red_to_white_p ), index);
+//
+//  These give the same colors as assigning the gradient palette to a
+//  CRGBPalette16, CRGBPalette32 or CRGBPalette256 does, but switching
+//  palettes is down to copying the table, or just pointing at it.  The
+//  gradient has to be defined with DEFINE_GRADIENT_PALETTE in the same
+//  file, and needs a C++11 compiler.
+
+#if __cplusplus > 199711L
+// constexpr, so that GRADIENT_PALETTE16 and friends can read the entries
+#define DEFINE_GRADIENT_PALETTE(X) \
+  FL_ALIGN_PROGMEM \
+  extern constexpr TProgmemRGBGradientPalette_byte X[] FL_PROGMEM =
+#else
 #define DEFINE_GRADIENT_PALETTE(X) \
   FL_ALIGN_PROGMEM \
   extern const TProgmemRGBGradientPalette_byte X[] FL_PROGMEM =
+#endif
 
 #define DECLARE_GRADIENT_PALETTE(X) \
   FL_ALIGN_PROGMEM \
   extern const TProgmemRGBGradientPalette_byte X[] FL_PROGMEM
 
+#if __cplusplus > 199711L
+template <uint16_t... I> struct CGradientSlots {};
+template <uint16_t N, uint16_t... I> struct CMakeGradientSlots : CMakeGradientSlots<N - 1, N - 1, I...> {};
+template <uint16_t... I> struct CMakeGradientSlots<0, I...> { typedef CGradientSlots<I...> type; };
+
+// The gradient palette G expanded to SLOTS (16, 32 or 256) colors, the same
+// way the CRGBPalette16/32/256 assignment operators do it, see
+// GRADIENT_PALETTE16 and friends above.  Each slot gets worked out on its
+// own: it takes its color from the last gradient segment covering it, and
+// that segment's fill_gradient_RGB step math.
+template <TProgmemRGBGradientPalette_bytes G, uint16_t SLOTS, typename I = typename CMakeGradientSlots<SLOTS>::type>
+class CGradientPalette;
+
+template <TProgmemRGBGradientPalette_bytes G, uint16_t SLOTS, uint16_t... I>
+class CGradientPalette<G, SLOTS, CGradientSlots<I...> > {
+    static constexpr uint8_t indexAt( uint8_t k) { return G[k * 4]; }
+    static constexpr uint8_t channelAt( uint8_t k, uint8_t c) { return G[(k * 4) + 1 + c]; }
+    static constexpr uint8_t slotOf( uint8_t index) { return index / (256 / SLOTS); }
+
+    // the 16 and 32 entry palettes move short segments along to keep them
+    // from landing in the same slot, if there are less than 16 entries
+    static constexpr uint8_t countFrom( uint8_t k) { return (indexAt(k) == 255) ? (k + 1) : countFrom(k + 1); }
+    static constexpr bool squeeze() { return (SLOTS != 256) && (countFrom(0) < 16); }
+
+    // the slots segment k (from entry k-1 to entry k) fills in, given the
+    // last slot filled in by the segments before it
+    static constexpr bool moved( uint8_t k, int16_t last) {
+        return squeeze() && (slotOf(indexAt(k - 1)) <= last) && (last < (SLOTS - 1));
+    }
+    static constexpr int16_t startOf( uint8_t k, int16_t last) {
+        return moved(k, last) ? (last + 1) : slotOf(indexAt(k - 1));
+    }
+    static constexpr int16_t endOf( uint8_t k, int16_t last) {
+        return (moved(k, last) && (slotOf(indexAt(k)) < (last + 1))) ? (last + 1) : slotOf(indexAt(k));
+    }
+    static constexpr int16_t nextLast( uint8_t k, int16_t last) { return squeeze() ? endOf(k, last) : last; }
+    static constexpr int16_t lowOf( uint8_t k, int16_t last) {
+        return (endOf(k, last) < startOf(k, last)) ? endOf(k, last) : startOf(k, last);
+    }
+    static constexpr int16_t highOf( uint8_t k, int16_t last) {
+        return (endOf(k, last) < startOf(k, last)) ? startOf(k, last) : endOf(k, last);
+    }
+    static constexpr bool covers( uint8_t k, int16_t last, uint16_t slot) {
+        return (lowOf(k, last) <= slot) && (slot <= highOf(k, last));
+    }
+
+    // one channel n steps into a gradient from s to e over dist steps,
+    // with fill_gradient_RGB's 8.7 fixed point deltas
+    static constexpr int16_t delta( uint8_t s, uint8_t e, int16_t dist) {
+        return (int16_t)(2 * (int16_t)((((int)e - (int)s) * 128) / (dist ? dist : 1)));
+    }
+    static constexpr uint8_t step( uint16_t n, uint8_t s, uint8_t e, int16_t dist) {
+        return (uint16_t)((s * 256) + (n * delta(s, e, dist))) >> 8;
+    }
+    static constexpr uint8_t channelIn( uint8_t k, int16_t last, uint16_t slot, uint8_t c) {
+        return (endOf(k, last) < startOf(k, last))
+            ? step(slot - lowOf(k, last), channelAt(k, c), channelAt(k - 1, c), highOf(k, last) - lowOf(k, last))
+            : step(slot - lowOf(k, last), channelAt(k - 1, c), channelAt(k, c), highOf(k, last) - lowOf(k, last));
+    }
+    static constexpr uint32_t colorIn( uint8_t k, int16_t last, uint16_t slot) {
+        return ((uint32_t)channelIn(k, last, slot, 0) << 16) | ((uint32_t)channelIn(k, last, slot, 1) << 8) | channelIn(k, last, slot, 2);
+    }
+
+    // walk the segments, keeping the last one covering slot
+    static constexpr uint32_t colorOf( uint16_t slot, uint8_t k = 1, int16_t last = -1, uint8_t found = 0, int16_t foundLast = -1) {
+        return (indexAt(k - 1) == 255)
+            ? (found ? colorIn(found, foundLast, slot) : 0)
+            : colorOf(slot, k + 1, nextLast(k, last),
+                      covers(k, last, slot) ? k : found, covers(k, last, slot) ? last : foundLast);
+    }
+
+public:
+    static const uint32_t entries[SLOTS];
+};
+
+template <TProgmemRGBGradientPalette_bytes G, uint16_t SLOTS, uint16_t... I>
+const uint32_t CGradientPalette<G, SLOTS, CGradientSlots<I...> >::entries[SLOTS] FL_PROGMEM = { colorOf(I)... };
+
+#define GRADIENT_PALETTE16(X)  (CGradientPalette<X, 16>::entries)
+#define GRADIENT_PALETTE32(X)  (CGradientPalette<X, 32>::entries)
+#define GRADIENT_PALETTE256(X) (CGradientPalette<X, 256>::entries)
+#endif
+
 
 // Functions to apply gamma adjustments, either:
 // - a single gamma adjustment to a single scalar value,
@@ -23,8 +23,30 @@ FASTLED_NAMESPACE_BEGIN
 
 #define DISABLE_DITHER 0x00
 #define BINARY_DITHER 0x01
+#define BAYER_DITHER 0x02
 typedef uint8_t EDitherMode;
 
+// Temporal dithering cycles through 2^n 'virtual bits' of extra precision, spread over that many updates.  The number
+// of bits gets picked from the measured update rate of each controller, so that a full dither cycle still
+// repeats at least MIN_ACCEPTABLE_DITHER_RATE_HZ times a second - any slower and it shows as flicker at low
+// brightness levels.  MAX_LIKELY_UPDATE_RATE_HZ is the rate assumed before a controller has been measured.
+#ifndef MAX_LIKELY_UPDATE_RATE_HZ
+#define MAX_LIKELY_UPDATE_RATE_HZ     400
+#endif
+#ifndef MIN_ACCEPTABLE_DITHER_RATE_HZ
+#define MIN_ACCEPTABLE_DITHER_RATE_HZ  50
+#endif
+#define UPDATES_PER_FULL_DITHER_CYCLE (MAX_LIKELY_UPDATE_RATE_HZ / MIN_ACCEPTABLE_DITHER_RATE_HZ)
+#define RECOMMENDED_VIRTUAL_BITS ((UPDATES_PER_FULL_DITHER_CYCLE>1) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>2) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>4) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>8) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>16) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>32) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>64) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>128) )
+#define VIRTUAL_BITS RECOMMENDED_VIRTUAL_BITS
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // LED Controller interface definition
@@ -40,13 +62,38 @@ class CLEDController {
 protected:
     friend class CFastLED;
     CRGB *m_Data;
-    CLEDController *m_pNext;
+    uint8_t m_nIndex;               ///< index of this controller in the registry, NO_CONTROLLER if not registered
     CRGB m_ColorCorrection;
     CRGB m_ColorTemperature;
     EDitherMode m_DitherMode;
     int m_nLeds;
-    static CLEDController *m_pHead;
-    static CLEDController *m_pTail;
+    uint32_t m_nShownHash;          ///< hash of the led data last written by showLedsIfChanged
+    uint32_t m_nShownAt;            ///< millis() at the last write by showLedsIfChanged
+    CRGB m_ShownAdjustment;         ///< brightness/color adjustment of the last write by showLedsIfChanged
+    EDitherMode m_ShownDither;      ///< dithering mode of the last write by showLedsIfChanged
+    const uint8_t *m_pShownTable;   ///< output table of the last write by showLedsIfChanged
+    float m_fShownGamma;            ///< gamma of the output table of the last write by showLedsIfChanged
+    bool m_bShownValid;             ///< false if the leds need to be written out by showLedsIfChanged
+    CRGB *m_pShownLeds;             ///< copy of the leds last written out, used for truncated frames
+    CRGB16 *m_pLeds16;              ///< 16 bit led data written out through m_Data, NULL for 8 bit led data
+    CTripleBuffer *m_pFrames;       ///< frames handed over by a rendering task, m_Data is the front one, NULL if not used
+    uint8_t *m_pOutputTable;        ///< 3x256 byte table mapping led data to output, see setOutputTable
+    float m_fGamma;                 ///< gamma built into the output table
+    CRGB m_TableScale;              ///< scale the output table was built for
+    bool m_bTableValid;             ///< false if the output table needs to be built again
+    uint32_t m_nChannelSums[3];     ///< cached sums of each color channel of the led data, see getChannelSums
+    bool m_bSumsValid;              ///< false if m_nChannelSums needs to be recomputed
+    bool m_bTrackWrites;            ///< true if led data only changes through setLed or gets marked with markChanged
+    uint8_t m_nPowerZone;           ///< power zone this controller draws from, 0 for none
+    uint32_t m_nLastWriteAt;        ///< micros() at the last write of this controller's leds
+    uint32_t m_nWriteInterval;      ///< running average of the µs between writes, used to pick the dithering depth
+    uint8_t m_nDitherPhase;         ///< frame counter for temporal dithering, moves on with every write of this controller
+#if FASTLED_PROFILE == 1
+    CTimingStats m_ShowStats;
+#endif
+    static CLEDController *m_pControllers[FASTLED_MAX_CONTROLLERS];
+    static uint8_t m_nControllers;
+    static bool m_bInShow;          ///< true while CFastLED hands a frame to every controller, see inShow
 
     /// set all the leds on the controller to a given color
     ///@param data the crgb color to set the leds to
@@ -60,15 +107,50 @@ protected:
 	///@param scale the rgb scaling to apply to each led before writing it out
     virtual void show(const struct CRGB *data, int nLeds, CRGB scale = CRGB(255,255,255) ) = 0;
 
+    /// write out 16 bit led data.  By default it gets brought down to 8 bits into the controller's own led data,
+    /// then written out from there - controllers for chipsets with more than 8 bits per channel can override this
+    /// to write the data out at their native depth.
+    ///@param data the 16 bit rgb data to write out to the strip
+    ///@param nLeds the number of leds being written out
+    ///@param scale the rgb scaling to apply to each led before writing it out
+    virtual void show16(const struct CRGB16 *data, int nLeds, CRGB scale) {
+        reduce16(data, m_Data, nLeds, scale, DISABLE_DITHER, 0, 0);
+        show(m_Data, nLeds, CRGB(255,255,255));
+    }
+
+#if FASTLED_OUTPUT_BYPASS == 1
+    /// get the output table for writing out leds with the given scale, building it first if the scale or gamma
+    /// changed since it was last built
+    const uint8_t *prepareOutputTable(CRGB scale) {
+        if(!m_bTableValid || scale != m_TableScale) {
+            buildOutputTable(scale);
+            m_TableScale = scale;
+            m_bTableValid = true;
+        }
+        return m_pOutputTable;
+    }
+
+    /// fill in the output table for the given scale and m_fGamma.  Defined in FastLED.cpp
+    void buildOutputTable(CRGB scale);
+#endif
+
+    /// bring 16 bit led data down to 8 bits, scaling each channel and dithering the dropped bits in one pass.
+    /// Defined in FastLED.cpp
+    static void reduce16(const struct CRGB16 *src, struct CRGB *dst, int nLeds, CRGB scale, EDitherMode dither, uint8_t ditherBits, uint8_t ditherPhase);
+
 public:
+    /// m_nIndex of a controller that isn't registered
+    static const uint8_t NO_CONTROLLER = 0xFF;
+
 	/// create an led controller object, add it to the chain of controllers
-    CLEDController() : m_Data(NULL), m_ColorCorrection(UncorrectedColor), m_ColorTemperature(UncorrectedTemperature), m_DitherMode(BINARY_DITHER), m_nLeds(0) {
-        m_pNext = NULL;
-        if(m_pHead==NULL) { m_pHead = this; }
-        if(m_pTail != NULL) { m_pTail->m_pNext = this; }
-        m_pTail = this;
+    CLEDController() : m_Data(NULL), m_nIndex(NO_CONTROLLER), m_ColorCorrection(UncorrectedColor), m_ColorTemperature(UncorrectedTemperature), m_DitherMode(BINARY_DITHER), m_nLeds(0), m_bShownValid(false), m_pShownLeds(NULL), m_pLeds16(NULL), m_pFrames(NULL), m_pOutputTable(NULL), m_fGamma(1.0f), m_bTableValid(false), m_bSumsValid(false), m_bTrackWrites(false), m_nPowerZone(0), m_nLastWriteAt(0), m_nWriteInterval(1000000 / MAX_LIKELY_UPDATE_RATE_HZ), m_nDitherPhase(0) {
+        registerController();
     }
 
+    /// take the controller out of the registry, so FastLED doesn't show a destroyed controller.  Backends writing
+    /// out in the background unregister in their own destructor, where waitForShow and freeBuffers still reach them
+    virtual ~CLEDController() { unregisterController(); }
+
 	///initialize the LED controller
 	virtual void init() = 0;
 
@@ -87,31 +169,266 @@ public:
 
     /// show function using the "attached to this controller" led data
     void showLeds(uint8_t brightness=255) {
-        show(m_Data, m_nLeds, getAdjustment(brightness));
+        if(m_pLeds16) {
+            show16(m_pLeds16, m_nLeds, getAdjustment(brightness));
+        } else {
+            show(m_Data, m_nLeds, getAdjustment(brightness));
+        }
     }
 
+    /// show function using the "attached to this controller" led data, which skips writing out the leds if
+    /// neither the data nor the brightness, correction, temperature or dithering mode changed since the last
+    /// call.  Change detection uses an FNV-1a hash of the led data, which is much cheaper than the write
+    /// itself.  With truncated frames enabled (see setTruncatedFrames) only the leds up to the last
+    /// changed one get written out.  Note that skipped frames also hold the temporal dithering of the last write.
+    /// Controllers showing 16 bit led data (see setLeds16) are always written out.
+    ///@param brightness the brightness to show the leds at
+    ///@param keepAlive write unchanged data anyway if the last write was at least this many ms ago, 0 for never
+    ///@returns true if the leds were written out
+    bool showLedsIfChanged(uint8_t brightness, uint16_t keepAlive) {
+        if(m_pLeds16) {
+            showLeds(brightness);
+            return true;
+        }
+
+        CRGB adj = getAdjustment(brightness);
+        uint32_t now = millis();
+
+        if(m_pShownLeds) {
+            int nLeds = m_nLeds;
+            if(shownWith(adj) && (keepAlive == 0 || (now - m_nShownAt) < keepAlive)) {
+                // the tail of the strip still holds what we wrote out last, only send up to the last changed led
+                while(nLeds && m_Data[nLeds-1] == m_pShownLeds[nLeds-1]) { nLeds--; }
+                if(nLeds == 0) { return false; }
+            } else {
+                m_nShownAt = now;
+                markShown(adj);
+            }
+            memcpy8((void*)m_pShownLeds, (const void*)m_Data, nLeds * sizeof(CRGB));
+            show(m_Data, nLeds, adj);
+            return true;
+        }
+
+        // a plain running sum misses edits that cancel out (e.g. +1/-2/+1 on neighbouring bytes), the multiply
+        // after every byte doesn't
+        uint32_t hash = 2166136261UL ^ m_nLeds;
+        const uint8_t *p = (const uint8_t*)m_Data;
+        const uint8_t *end = p + (m_nLeds * 3);
+        while(p != end) {
+            hash ^= *p++;
+            hash *= 16777619UL;
+        }
+
+        if(hash == m_nShownHash && shownWith(adj)) {
+            if(keepAlive == 0 || (now - m_nShownAt) < keepAlive) {
+                return false;
+            }
+        }
+
+        show(m_Data, m_nLeds, adj);
+        m_nShownHash = hash;
+        m_nShownAt = now;
+        markShown(adj);
+        return true;
+    }
+
+    /// whether the last write by showLedsIfChanged went out with the adjustment adj and the current dithering
+    /// mode, output table and gamma
+    bool shownWith(const CRGB & adj) {
+        return m_bShownValid && adj == m_ShownAdjustment && m_DitherMode == m_ShownDither &&
+               m_pOutputTable == m_pShownTable && m_fGamma == m_fShownGamma;
+    }
+
+    /// remember the settings a write by showLedsIfChanged went out with, see shownWith
+    void markShown(const CRGB & adj) {
+        m_ShownAdjustment = adj;
+        m_ShownDither = m_DitherMode;
+        m_pShownTable = m_pOutputTable;
+        m_fShownGamma = m_fGamma;
+        m_bShownValid = true;
+    }
+
+    /// make the next showLedsIfChanged call write out the leds, e.g. after other data was shown on them
+    void invalidate() { m_bShownValid = false; }
+
+    /// Get the sums of each color channel over all leds, as used for power estimation.  These are recomputed on
+    /// every call, unless write tracking is enabled (see setWriteTracking), in which case they are only
+    /// recomputed after markChanged and kept up to date by setLed otherwise.
+    ///@returns the red, green and blue channel sums
+    const uint32_t *getChannelSums();
+
+    /// Promise that the led data only gets changed through setLed, or that markChanged gets called after
+    /// changing it any other way.  This lets power limiting use cached channel sums instead of going over
+    /// all of the led data on every show.
+    CLEDController & setWriteTracking(bool track) { m_bTrackWrites = track; m_bSumsValid = false; return *this; }
+    /// check if write tracking is enabled for this controller
+    bool getWriteTracking() { return m_bTrackWrites; }
+
+    /// Assign this controller to a power zone, i.e. one of the power supplies of an installation, which has its own
+    /// power limit (see CFastLED::setZoneMaxPowerInMilliWatts).  To split one array of leds between zones, add
+    /// a controller for each part of it.
+    ///@param zone the zone, from 1 to FASTLED_POWER_ZONES - or 0 to only be held to the global power limit
+    CLEDController & setPowerZone(uint8_t zone) { m_nPowerZone = (zone <= FASTLED_POWER_ZONES) ? zone : 0; return *this; }
+    /// get the power zone this controller is assigned to, 0 for none
+    uint8_t getPowerZone() { return m_nPowerZone; }
+
+    /// set the n'th led, keeping the cached channel sums up to date
+    void setLed(int n, const CRGB & color) {
+        if(m_bSumsValid) {
+            for(uint8_t i = 0; i < 3; i++) {
+                m_nChannelSums[i] += color.raw[i];
+                m_nChannelSums[i] -= m_Data[n].raw[i];
+            }
+        }
+        m_Data[n] = color;
+    }
+
+    /// let the controller know that its led data was changed other than through setLed
+    void markChanged() { m_bSumsValid = false; }
+
 	/// show the given color on the led strip
     void showColor(const struct CRGB & data, uint8_t brightness=255) {
         showColor(data, m_nLeds, getAdjustment(brightness));
     }
 
     /// get the first led controller in the chain of controllers
-    static CLEDController *head() { return m_pHead; }
+    static CLEDController *head() { return m_nControllers ? m_pControllers[0] : NULL; }
     /// get the next controller in the chain after this one.  will return NULL at the end of the chain
-    CLEDController *next() { return m_pNext; }
+    CLEDController *next() { return (m_nIndex + 1 < m_nControllers) ? m_pControllers[m_nIndex + 1] : NULL; }
+
+    /// get the number of registered controllers
+    static uint8_t count() { return m_nControllers; }
+    /// whether CFastLED is handing a frame to every controller right now, and calls endShow once it is done.
+    /// Backends that queue frames until endShow start them right away when shown on their own
+    static bool inShow() { return m_bInShow; }
+    /// get the n'th registered controller, in the order they were registered in.  will return NULL past the end
+    static CLEDController *controller(uint8_t n) { return (n < m_nControllers) ? m_pControllers[n] : NULL; }
+    /// get the position of this controller amongst the registered controllers, NO_CONTROLLER if it isn't registered
+    uint8_t index() { return m_nIndex; }
+
+    /// Add this controller to the end of the registry, so that FastLED shows it.  Controllers register themselves
+    /// when created, this is for putting back one that was unregistered.
+    ///@returns false if FASTLED_MAX_CONTROLLERS controllers are registered already
+    bool registerController() {
+        if(m_nIndex != NO_CONTROLLER) { return true; }
+        if(m_nControllers >= FASTLED_MAX_CONTROLLERS) { return false; }
+        m_nIndex = m_nControllers++;
+        m_pControllers[m_nIndex] = this;
+        return true;
+    }
 
-	/// set the default array of leds to be used by this controller
+    /// Remove this controller from the registry, so that FastLED no longer shows it.  The controllers after it move
+    /// up one place, keeping their order.  Waits for the last frame to be written out, then lets the controller
+    /// free its output buffers.
+    void unregisterController() {
+        if(m_nIndex == NO_CONTROLLER) { return; }
+        waitForShow();
+        freeBuffers();
+        for(uint8_t i = m_nIndex + 1; i < m_nControllers; i++) {
+            m_pControllers[i-1] = m_pControllers[i];
+            m_pControllers[i-1]->m_nIndex = i-1;
+        }
+        m_nControllers--;
+        m_nIndex = NO_CONTROLLER;
+    }
+
+	/// set the default array of leds to be used by this controller.  Can be used to resize or move the leds of
+    /// a controller between frames, as it waits for the last frame to be written out first.  Growing a controller
+    /// with truncated frames turns those off, as the array passed to setTruncatedFrames would be too small
     CLEDController & setLeds(CRGB *data, int nLeds) {
+        waitForShow();
+        if(nLeds > m_nLeds) { m_pShownLeds = NULL; }
         m_Data = data;
         m_nLeds = nLeds;
+        m_pFrames = NULL;
+        m_bShownValid = false;
+        m_bSumsValid = false;
+        return *this;
+    }
+
+    /// show frames drawn by another task (or core), handed over through a triple buffer - see CTripleBuffer.
+    /// FastLED.show() picks up the newest published frame for every controller, or writes out the previous one
+    /// again if there is no new one.
+    CLEDController & setLeds(CTripleBuffer & frames, int nLeds) {
+        setLeds(frames.front(), nLeds);
+        m_pFrames = &frames;
+        return *this;
+    }
+
+    /// switch over to the newest frame published to the triple buffer set with setLeds, if there is one.  Called
+    /// by FastLED.show() before working out the power limits and writing out the leds.
+    void acquireFrame() {
+        if(m_pFrames && m_pFrames->acquire()) {
+            m_Data = m_pFrames->front();
+            m_bSumsValid = false;
+        }
+    }
+
+    /// Only write out the leds up to the last one that changed since the previous frame.  This relies on the
+    /// leds past the end of a frame keeping their color, so it is ignored for chipsets that don't do that (see
+    /// canTruncateFrames).  A truncating controller is always shown through showLedsIfChanged.
+    ///@param shownLeds an array of (at least) as many leds as this controller has, used to keep a copy of the
+    /// leds as they were last written out - or NULL to go back to writing out full frames
+    CLEDController & setTruncatedFrames(CRGB *shownLeds) {
+        m_pShownLeds = canTruncateFrames() ? shownLeds : NULL;
+        m_bShownValid = false;
+        return *this;
+    }
+    /// check if this controller only writes out the leds up to the last changed one
+    bool getTruncatedFrames() { return m_pShownLeds != NULL; }
+
+    /// Show 16 bit led data on this controller.  On every write it gets scaled for brightness and color correction
+    /// and brought down to the chipset's bit depth in one pass, using the controller's dithering mode for the
+    /// dropped bits.  The 8 bit leds set with setLeds/addLeds act as the output buffer, so need to be a separate
+    /// array of the same number of leds.
+    ///@param pLeds16 the 16 bit leds, or NULL to go back to showing the 8 bit leds
+    CLEDController & setLeds16(CRGB16 *pLeds16) {
+        waitForShow();
+        m_pLeds16 = pLeds16;
+        m_bShownValid = false;
+        m_bSumsValid = false;
+        return *this;
+    }
+    /// get the 16 bit leds shown by this controller, NULL if it shows 8 bit leds
+    CRGB16 *getLeds16() { return m_pLeds16; }
+
+#if FASTLED_OUTPUT_BYPASS == 1
+    /// Write out the leds through a lookup table combining brightness, color correction, temperature and gamma
+    /// (see setGamma), built whenever one of those changes.  Each byte then takes a single load from the table on
+    /// its way out, instead of dithering and scaling, so there's no dithering with a table.  16 bit led data and
+    /// drivers that scale in their own asm (see canShowRaw) don't use the table.  Needs FASTLED_OUTPUT_BYPASS.
+    ///@param table an array of 3*256 bytes for this controller alone to build the table in, or NULL to stop using one
+    CLEDController & setOutputTable(uint8_t *table) {
+        waitForShow();
+        m_pOutputTable = table;
+        m_bTableValid = false;
+        invalidate();
+        return *this;
+    }
+    /// get the array the output table is built in, NULL if there's no output table
+    uint8_t *getOutputTable() { return m_pOutputTable; }
+
+    /// set the gamma built into the output table (see setOutputTable), 1.0 for none.  Typical values for leds are
+    /// 2.2 to 2.8
+    CLEDController & setGamma(float gamma) {
+        m_fGamma = gamma;
+        m_bTableValid = false;
+        invalidate();
         return *this;
     }
+    /// get the gamma built into the output table
+    float getGamma() { return m_fGamma; }
+#endif
 
 	/// zero out the led data managed by this controller
     void clearLedData() {
         if(m_Data) {
             memset8((void*)m_Data, 0, sizeof(struct CRGB) * m_nLeds);
         }
+        if(m_pLeds16) {
+            memset8((void*)m_pLeds16, 0, sizeof(struct CRGB16) * m_nLeds);
+        }
+        m_bSumsValid = false;
     }
 
     /// How many leds does this controller manage?
@@ -123,11 +440,46 @@ public:
     /// Reference to the n'th item in the controller
     CRGB &operator[](int x) { return m_Data[x]; }
 
-	/// set the dithering mode for this controller to use
+	/// set the dithering mode for this controller to use, one of DISABLE_DITHER, BINARY_DITHER or BAYER_DITHER
     inline CLEDController & setDither(uint8_t ditherMode = BINARY_DITHER) { m_DitherMode = ditherMode; return *this; }
     /// get the dithering option currently set for this controller
     inline uint8_t getDither() { return m_DitherMode; }
 
+    /// get the measured rate, in Hz, at which this controller's leds get written out
+    uint32_t getRefreshRate() { return 1000000 / m_nWriteInterval; }
+
+    /// get the number of virtual bits of temporal dithering the measured refresh rate supports, 0 if this controller
+    /// is written out too slowly to dither without flicker.
+    uint8_t getDitherBits() {
+        // the number of updates in one MIN_ACCEPTABLE_DITHER_RATE_HZ period has to be more than 2^bits - compare
+        // against shifted intervals instead of dividing
+        const uint32_t period = 1000000 / MIN_ACCEPTABLE_DITHER_RATE_HZ;
+        uint8_t bits = 0;
+        if(m_nWriteInterval < period) {
+            while(bits < 8 && (m_nWriteInterval << (bits+1)) <= period) { bits++; }
+        }
+        return bits;
+    }
+
+protected:
+    /// note that the leds are about to be written out, updating the measured refresh rate and moving the dither
+    /// phase on, and get the number of virtual dithering bits to use for this write
+    uint8_t nextDitherBits() {
+        m_nDitherPhase++;
+        uint32_t now = micros();
+        uint32_t interval = now - m_nLastWriteAt;
+        m_nLastWriteAt = now;
+        // long pauses between writes (startup, skipped unchanged frames) get clamped, so the average
+        // recovers quickly once the controller is written out regularly again
+        if(interval > 1000000) { interval = 1000000; }
+        if(interval == 0) { interval = 1; }
+        m_nWriteInterval = ((m_nWriteInterval * 3) + interval) >> 2;
+        if(m_nWriteInterval == 0) { m_nWriteInterval = 1; }
+        return getDitherBits();
+    }
+
+public:
+
 	/// the the color corrction to use for this controller, expressed as an rgb object
     CLEDController & setCorrection(CRGB correction) { m_ColorCorrection = correction; return *this; }
     /// set the color correction to use for this controller
@@ -169,6 +521,50 @@ public:
       #endif
     }
     virtual uint16_t getMaxRefreshRate() const { return 0; }
+    /// whether the leds keep their color when a frame stops short of them, i.e. if it is safe to only write
+    /// out the first part of the strip
+    virtual bool canTruncateFrames() const { return false; }
+    /// whether the controller can write out raw data that is already in wire order, scaled and dithered (see
+    /// showRaw).  Needs FASTLED_OUTPUT_BYPASS, and drivers that dither and scale in their own asm can't
+    virtual bool canShowRaw() const { return false; }
+
+    /// Write out led data that is already in the wire order of the chipset, scaled and dithered, straight from the
+    /// caller's buffer - no reordering, brightness, color correction, dithering or output table.  For data coming
+    /// in over the network, or animations that were worked out ahead of time.  Power limiting doesn't see raw data,
+    /// and nothing is written out if the controller can't show raw data (see canShowRaw).
+    ///@param data three bytes per led, in the order they go out on the wire
+    ///@param nBytes the number of bytes of data, which is rounded down to whole leds
+    virtual void showRaw(const uint8_t *data, int nBytes) { }
+
+    /// Capture the next frame of this controller's leds as it would be written out - in the wire order of the
+    /// chipset, with brightness, color correction, dithering (moving on by one frame) and the output table applied
+    /// - to write it out again later with showCapturedFrame, without any of that work.  Sequences of captured
+    /// frames can replay looping content, including the temporal dithering.
+    ///@param frame an array of (at least) 3 bytes per led to capture the frame into
+    ///@param brightness the brightness to capture the leds at
+    ///@returns the number of bytes captured, 0 if the controller can't show raw data
+    virtual int captureFrame(uint8_t *frame, uint8_t brightness=255) { return 0; }
+
+    /// write out a frame captured with captureFrame, as it is.  The controller needs to have the same number of
+    /// leds as when the frame was captured
+    void showCapturedFrame(const uint8_t *frame) { showRaw(frame, m_nLeds * 3); }
+
+    /// Called by CFastLED once every controller was handed its data for a frame.  Backends that gather a frame
+    /// from several controllers before writing it out in the background (e.g. the esp32 rmt driver) start here.
+    virtual void endShow() { }
+    /// check if a frame handed to this controller is still being written out in the background.  The led data
+    /// itself is free to be changed as soon as show returns, busy or not
+    virtual bool isBusy() { return false; }
+    /// wait until this controller finished writing out the last frame handed to it
+    virtual void waitForShow() { }
+    /// free any buffers allocated for writing out the leds, called when the controller gets unregistered.  They
+    /// get allocated again if the controller is registered and shown again
+    virtual void freeBuffers() { }
+
+#if FASTLED_PROFILE == 1
+    /// timing statistics, in µs, for writing out this controller's leds in FastLED.show()
+    CTimingStats & getShowStats() { return m_ShowStats; }
+#endif
 };
 
 // Pixel controller class.  This is the class that we use to centralize pixel access in a block of data, including
@@ -183,6 +579,10 @@ struct PixelController {
         CRGB mScale;
         int8_t mAdvance;
         int mOffsets[LANES];
+        uint8_t f[3];                   ///< the other pair of dither values, swapped with d every other pixel by BAYER_DITHER
+        uint8_t mBayerStep;             ///< position in the group of four pixels for BAYER_DITHER, 0 for other modes
+        const uint8_t *mTable;          ///< output table of 3x256 bytes replacing dithering and scaling, NULL if not used
+        bool mBypass;                   ///< true if bytes go out through mTable, or unchanged for raw data in wire order
 
         PixelController(const PixelController & other) {
             d[0] = other.d[0];
@@ -196,6 +596,12 @@ struct PixelController {
             mAdvance = other.mAdvance;
             mLenRemaining = mLen = other.mLen;
             for(int i = 0; i < LANES; i++) { mOffsets[i] = other.mOffsets[i]; }
+            f[0] = other.f[0];
+            f[1] = other.f[1];
+            f[2] = other.f[2];
+            mBayerStep = other.mBayerStep;
+            mTable = other.mTable;
+            mBypass = other.mBypass;
 
         }
 
@@ -207,65 +613,76 @@ struct PixelController {
           }
         }
 
-        PixelController(const uint8_t *data, int len, CRGB & s, EDitherMode dither = BINARY_DITHER, bool advance=true, uint8_t skip=0) : mData(data), mLen(len), mLenRemaining(len), mScale(s) {
+        PixelController(const uint8_t *data, int len, CRGB & s, EDitherMode dither = BINARY_DITHER, bool advance=true, uint8_t skip=0) : mData(data), mLen(len), mLenRemaining(len), mScale(s), mTable(NULL), mBypass(false) {
             enable_dithering(dither);
             mData += skip;
             mAdvance = (advance) ? 3+skip : 0;
             initOffsets(len);
         }
 
-        PixelController(const CRGB *data, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)data), mLen(len), mLenRemaining(len), mScale(s) {
-            enable_dithering(dither);
+        PixelController(const CRGB *data, int len, CRGB & s, EDitherMode dither = BINARY_DITHER, uint8_t ditherBits = VIRTUAL_BITS, uint8_t ditherPhase = 0) : mData((const uint8_t*)data), mLen(len), mLenRemaining(len), mScale(s), mTable(NULL), mBypass(false) {
+            enable_dithering(dither, ditherBits, ditherPhase);
             mAdvance = 3;
             initOffsets(len);
         }
 
-        PixelController(const CRGB &data, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)&data), mLen(len), mLenRemaining(len), mScale(s) {
-            enable_dithering(dither);
+        PixelController(const CRGB &data, int len, CRGB & s, EDitherMode dither = BINARY_DITHER, uint8_t ditherBits = VIRTUAL_BITS, uint8_t ditherPhase = 0) : mData((const uint8_t*)&data), mLen(len), mLenRemaining(len), mScale(s), mTable(NULL), mBypass(false) {
+            enable_dithering(dither, ditherBits, ditherPhase);
             mAdvance = 0;
             initOffsets(len);
         }
 
-        void init_binary_dithering() {
+        /// set up the dither signal for the frame at the given phase of the controller, cycling through
+        /// 2^ditherBits steps over successive frames.  The number of bits comes from the measured update rate of
+        /// the controller (see CLEDController::getDitherBits), 0 turns dithering off.
+        void init_binary_dithering(uint8_t ditherBits = VIRTUAL_BITS, uint8_t ditherPhase = 0) {
 #if !defined(NO_DITHERING) || (NO_DITHERING != 1)
 
-            // Set 'virtual bits' of dithering to the highest level
-            // that is not likely to cause excessive flickering at
-            // low brightness levels + low update rates.
-            // These pre-set values are a little ambitious, since
-            // a 400Hz update rate for WS2811-family LEDs is only
-            // possible with 85 pixels or fewer.
-            // Once we have a 'number of milliseconds since last update'
-            // value available here, we can quickly calculate the correct
-            // number of 'virtual bits' on the fly with a couple of 'if'
-            // statements -- no division required.  At this point,
-            // the division is done at compile time, so there's no runtime
-            // cost, but the values are still hard-coded.
-#define MAX_LIKELY_UPDATE_RATE_HZ     400
-#define MIN_ACCEPTABLE_DITHER_RATE_HZ  50
-#define UPDATES_PER_FULL_DITHER_CYCLE (MAX_LIKELY_UPDATE_RATE_HZ / MIN_ACCEPTABLE_DITHER_RATE_HZ)
-#define RECOMMENDED_VIRTUAL_BITS ((UPDATES_PER_FULL_DITHER_CYCLE>1) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>2) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>4) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>8) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>16) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>32) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>64) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>128) )
-#define VIRTUAL_BITS RECOMMENDED_VIRTUAL_BITS
+            if(ditherBits == 0) {
+                d[0]=d[1]=d[2]=e[0]=e[1]=e[2]=0;
+                return;
+            }
 
-            // R is the digther signal 'counter'.
-            static uint8_t R = 0;
-            R++;
+            // Q is the "unscaled dither signal" itself, the reversed bits of the
+            // phase counter.  If 'ditherBits' is 2, Q will cycle through (31, 159, 95, 223)
+            uint8_t Q = ditherSignal(ditherPhase, ditherBits);
 
-            // R is wrapped around at 2^ditherBits,
-            // so if ditherBits is 2, R will cycle through (0,1,2,3)
-            uint8_t ditherBits = VIRTUAL_BITS;
+            // D and E form the "scaled dither signal"
+            // which is added to pixel values to affect the
+            // actual dithering.
+            scaleDitherSignal(Q, d);
+#endif
+        }
+
+        /// set up ordered (Bayer style) dithering.  Besides the dither signal moving on every frame, groups of
+        /// four neighbouring pixels get spread out across the four quarters of the range of the signal.  Two bits
+        /// of extra precision come from that spatial pattern alone, so it still smooths out low brightness
+        /// gradients on strips too slow for temporal dithering.  On faster ones the quarter each pixel starts out
+        /// in moves on with every frame as well, so that d and e alone (which is all that drivers dithering in
+        /// their own asm look at) carry a full amplitude binary dither signal.
+        void init_bayer_dithering(uint8_t ditherBits = VIRTUAL_BITS, uint8_t ditherPhase = 0) {
+#if !defined(NO_DITHERING) || (NO_DITHERING != 1)
+            // the frame moves the signal on just like binary dithering, only centered on the finer steps that the
+            // pixel position adds two more bits of
+            if(ditherBits > 6) { ditherBits = 6; }
+            uint8_t Q = ditherSignal(ditherPhase & ((0x01 << ditherBits) - 1), ditherBits + 2);
+
+            // stepDithering alternates between d and its complement, which takes care of pixels 1 and 3 of each
+            // group of four - flipping the low bit of the quarter for d gives the other pair, swapped in every
+            // other pixel
+            scaleDitherSignal(Q, d);
+            scaleDitherSignal(Q ^ 0x40, f);
+            mBayerStep = 1;
+#endif
+        }
+
+        /// reverse the bits of the ditherBits wide counter R into the top of a byte, then move the result to the
+        /// center of the range it stands for.  If ditherBits is 2, R cycles through (0,1,2,3) and the signal
+        /// through (0,128,64,192) before, and (31,159,95,223) after the adjustment.
+        static uint8_t ditherSignal(uint8_t R, uint8_t ditherBits) {
+            // R is wrapped around at 2^ditherBits
             R &= (0x01 << ditherBits) - 1;
 
-            // Q is the "unscaled dither signal" itself.
-            // It's initialized to the reversed bits of R.
-            // If 'ditherBits' is 2, Q here will cycle through (0,128,64,192)
             uint8_t Q = 0;
 
             // Reverse bits in a byte
@@ -282,27 +699,47 @@ struct PixelController {
 
             // Now we adjust Q to fall in the center of each range,
             // instead of at the start of the range.
-            // If ditherBits is 2, Q will be (0, 128, 64, 192) at first,
-            // and this adjustment makes it (31, 159, 95, 223).
             if( ditherBits < 8) {
                 Q += 0x01 << (7 - ditherBits);
             }
+            return Q;
+        }
 
-            // D and E form the "scaled dither signal"
-            // which is added to pixel values to affect the
-            // actual dithering.
-
-            // Setup the initial D and E values
+        /// scale the dither signal Q to the step size of each channel at the current scale, setting up E and
+        /// the given D values
+        void scaleDitherSignal(uint8_t Q, uint8_t *dd) {
             for(int i = 0; i < 3; i++) {
                     uint8_t s = mScale.raw[i];
-                    e[i] = s ? (256/s) + 1 : 0;
-                    d[i] = scale8(Q, e[i]);
+                    uint8_t ee = s ? (256/s) + 1 : 0;
+                    dd[i] = scale8(Q, ee);
 #if (FASTLED_SCALE8_FIXED == 1)
-                    if(d[i]) (d[i]--);
+                    if(dd[i]) (dd[i]--);
 #endif
-                    if(e[i]) e[i]--;
+                    if(ee) ee--;
+                    e[i] = ee;
             }
-#endif
+        }
+
+        /// map each byte through the given table of 3x256 bytes (one row each for red, green and blue) instead
+        /// of dithering and scaling it.  Drivers that dither and scale in their own asm don't use the table.  The
+        /// table has the scale built in, so drivers asking for it (e.g. for the global brightness of APA102) get a
+        /// unit scale.
+        void setOutputTable(const uint8_t *table) {
+            mTable = table;
+            mBypass = (table != NULL);
+            if(table) {
+                mScale = CRGB(255,255,255);
+                enable_dithering(DISABLE_DITHER);
+            }
+        }
+
+        /// write the data out exactly as it is: three bytes per led, already in the wire order of the chipset,
+        /// scaled and dithered.  Drivers that dither and scale in their own asm don't support raw data (see
+        /// CLEDController::canShowRaw).
+        void setRaw() {
+            mTable = NULL;
+            mBypass = true;
+            enable_dithering(DISABLE_DITHER);
         }
 
         // Do we have n pixels left to process?
@@ -311,9 +748,11 @@ struct PixelController {
         }
 
         // toggle dithering enable
-        void enable_dithering(EDitherMode dither) {
+        void enable_dithering(EDitherMode dither, uint8_t ditherBits = VIRTUAL_BITS, uint8_t ditherPhase = 0) {
+            mBayerStep = 0;
             switch(dither) {
-                case BINARY_DITHER: init_binary_dithering(); break;
+                case BINARY_DITHER: init_binary_dithering(ditherBits, ditherPhase); break;
+                case BAYER_DITHER: init_bayer_dithering(ditherBits, ditherPhase); break;
                 default: d[0]=d[1]=d[2]=e[0]=e[1]=e[2]=0; break;
             }
         }
@@ -335,6 +774,20 @@ struct PixelController {
                 d[2] = e[2] - d[2];
         }
 
+        // every other pixel, swap in the other pair of dither values for BAYER_DITHER.  Only drivers that aren't
+        // cycle counted call this, after stepDithering, so stepDithering stays branch free; all others use d and e
+        // only, which leaves them with binary dithering.
+        inline void stepBayerDithering() {
+            if(!mBayerStep) { return; }
+            mBayerStep ^= 0x03;
+            if(mBayerStep == 0x01) {
+                uint8_t t;
+                t = d[0]; d[0] = f[0]; f[0] = t;
+                t = d[1]; d[1] = f[1]; f[1] = t;
+                t = d[2]; d[2] = f[2]; f[2] = t;
+            }
+        }
+
         // Some chipsets pre-cycle the first byte, which means we want to cycle byte 0's dithering separately
         __attribute__((always_inline)) inline void preStepFirstByteDithering() {
             d[RO(0)] = e[RO(0)] - d[RO(0)];
@@ -349,11 +802,22 @@ struct PixelController {
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t scale(PixelController & pc, uint8_t b) { return scale8(b, pc.mScale.raw[RO(SLOT)]); }
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t scale(PixelController & , uint8_t b, uint8_t scale) { return scale8(b, scale); }
 
+        // output without dithering and scaling - a lookup in the output table, or raw data that's already in wire order
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t bypass(PixelController & pc) { return pc.mTable ? pc.mTable[(RO(SLOT) << 8) + pc.loadByte<SLOT>(pc)] : pc.mData[SLOT]; }
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t bypass(PixelController & pc, int lane) { return pc.mTable ? pc.mTable[(RO(SLOT) << 8) + pc.loadByte<SLOT>(pc, lane)] : pc.mData[pc.mOffsets[lane] + SLOT]; }
+
         // composite shortcut functions for loading, dithering, and scaling
+#if FASTLED_OUTPUT_BYPASS == 1
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc) { return pc.mBypass ? bypass<SLOT>(pc) : scale<SLOT>(pc, pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc))); }
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane) { return pc.mBypass ? bypass<SLOT>(pc, lane) : scale<SLOT>(pc, pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc, lane))); }
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane, uint8_t di, uint8_t scale) { return pc.mBypass ? bypass<SLOT>(pc, lane) : scale8(pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc, lane), di), scale); }
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane, uint8_t scale) { return pc.mBypass ? bypass<SLOT>(pc, lane) : scale8(pc.loadByte<SLOT>(pc, lane), scale); }
+#else
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc) { return scale<SLOT>(pc, pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc))); }
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane) { return scale<SLOT>(pc, pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc, lane))); }
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane, uint8_t di, uint8_t scale) { return scale8(pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc, lane), di), scale); }
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane, uint8_t scale) { return scale8(pc.loadByte<SLOT>(pc, lane), scale); }
+#endif
 
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t advanceAndLoadAndScale(PixelController & pc) { pc.advanceData(); return pc.loadAndScale<SLOT>(pc); }
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t advanceAndLoadAndScale(PixelController & pc, int lane) { pc.advanceData(); return pc.loadAndScale<SLOT>(pc, lane); }
@@ -395,7 +859,11 @@ protected:
   ///@param nLeds the numner of leds to set to this color
   ///@param scale the rgb scaling value for outputting color
   virtual void showColor(const struct CRGB & data, int nLeds, CRGB scale) {
-    PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds, scale, getDither());
+    uint8_t ditherBits = nextDitherBits();
+    PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds, scale, getDither(), ditherBits, m_nDitherPhase);
+#if FASTLED_OUTPUT_BYPASS == 1
+    if(m_pOutputTable) { pixels.setOutputTable(prepareOutputTable(scale)); }
+#endif
     showPixels(pixels);
   }
 
@@ -404,12 +872,67 @@ protected:
 ///@param nLeds the number of leds being written out
 ///@param scale the rgb scaling to apply to each led before writing it out
   virtual void show(const struct CRGB *data, int nLeds, CRGB scale) {
-    PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds, scale, getDither());
+    uint8_t ditherBits = nextDitherBits();
+    PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds, scale, getDither(), ditherBits, m_nDitherPhase);
+#if FASTLED_OUTPUT_BYPASS == 1
+    if(m_pOutputTable) { pixels.setOutputTable(prepareOutputTable(scale)); }
+#endif
+    showPixels(pixels);
+  }
+
+/// write out 16 bit rgb data, brought down to 8 bits (with dithering) into the controller's own led data
+///@param data the 16 bit rgb data to write out to the strip
+///@param nLeds the number of leds being written out
+///@param scale the rgb scaling to apply to each led before writing it out
+  virtual void show16(const struct CRGB16 *data, int nLeds, CRGB scale) {
+    uint8_t ditherBits = nextDitherBits();
+    reduce16(data, m_Data, nLeds, scale, getDither(), ditherBits, m_nDitherPhase);
+    CRGB unscaled(255,255,255);
+    PixelController<RGB_ORDER, LANES, MASK> pixels(m_Data, nLeds, unscaled, DISABLE_DITHER);
     showPixels(pixels);
   }
 
 public:
   CPixelLEDController() : CLEDController() {}
+
+  virtual bool canShowRaw() const { return FASTLED_OUTPUT_BYPASS == 1; }
+
+  virtual int captureFrame(uint8_t *frame, uint8_t brightness=255) {
+    if(!canShowRaw()) { return 0; }
+    CRGB scale = getAdjustment(brightness);
+    // capturing doesn't count as a write for the measured refresh rate, but does move the dithering on
+    uint8_t ditherBits = getDitherBits();
+    m_nDitherPhase++;
+    const CRGB *data = m_Data;
+    if(m_pLeds16) {
+      reduce16(m_pLeds16, m_Data, m_nLeds, scale, getDither(), ditherBits, m_nDitherPhase);
+      scale = CRGB(255,255,255);
+    }
+    PixelController<RGB_ORDER, LANES, MASK> pixels(data, m_nLeds, scale, m_pLeds16 ? DISABLE_DITHER : getDither(), ditherBits, m_nDitherPhase);
+#if FASTLED_OUTPUT_BYPASS == 1
+    if(m_pOutputTable && !m_pLeds16) { pixels.setOutputTable(prepareOutputTable(scale)); }
+#endif
+    uint8_t *p = frame;
+    while(pixels.has(1)) {
+      *p++ = pixels.loadAndScale0();
+      *p++ = pixels.loadAndScale1();
+      *p++ = pixels.loadAndScale2();
+      pixels.advanceData();
+      pixels.stepDithering();
+      pixels.stepBayerDithering();
+    }
+    return p - frame;
+  }
+
+  virtual void showRaw(const uint8_t *data, int nBytes) {
+    if(!canShowRaw()) { return; }
+    nextDitherBits();
+    CRGB unscaled(255,255,255);
+    PixelController<RGB_ORDER, LANES, MASK> pixels(data, nBytes / 3, unscaled, DISABLE_DITHER);
+    pixels.setRaw();
+    showPixels(pixels);
+    invalidate();
+  }
 };
 
 
@@ -15,6 +15,7 @@
 #  define ALWAYS_INLINE  __attribute__((always_inline))
 #  define HOT            __attribute__((hot))
 #  define NO_INLINE      __attribute__((noinline))
+#  define OPTIMIZE_SPEED
 // do not initialize global or static variable
 // this depends on compiler support or a NOLOAD section in the linker script
 // e.g. __attribute__ ((section (".noinit")))
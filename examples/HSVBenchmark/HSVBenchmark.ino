@@ -0,0 +1,68 @@
+#include <FastLED.h>
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Rainbow conversion benchmark
+//
+// Times converting arrays of CHSV colors with hsv2rgb_rainbow against converting them one led at a
+// time, for a range of strip lengths, and checks that both give the same colors.  The array version
+// converts a batch of leds at a time with SSE2/AVX2 or NEON instructions when building for targets
+// that have them, and without branching on the hue on Cortex M4/M7.
+//
+// No leds need to be connected, the results get printed to the serial port.  Lower MAX_LEDS if
+// your board doesn't have enough memory for the larger sizes (each led takes 6 bytes here).
+//
+//////////////////////////////////////////////////
+
+#if defined(__AVR__)
+#define MAX_LEDS 200
+#else
+#define MAX_LEDS 20000
+#endif
+
+// How many times to convert the leds for each measurement
+#define ROUNDS 100
+
+CHSV hsv[MAX_LEDS];
+CRGB single[MAX_LEDS];
+CRGB batched[MAX_LEDS];
+
+const uint16_t sizes[] = { 100, 200, 1000, 5000, 10000, 20000 };
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+
+  random16_set_seed(1234);
+  for(int i = 0; i < MAX_LEDS; i++) {
+    hsv[i] = CHSV(random8(), random8(), random8());
+  }
+}
+
+void loop() {
+  Serial.print("leds\tsingle\t\tbatched\t(us for "); Serial.print(ROUNDS); Serial.println(" runs)\tspeedup");
+  for(uint8_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    uint16_t n = sizes[i];
+    if(n > MAX_LEDS) { break; }
+
+    uint32_t start = micros();
+    for(int r = 0; r < ROUNDS; r++) {
+      for(uint16_t j = 0; j < n; j++) { hsv2rgb_rainbow(hsv[j], single[j]); }
+    }
+    uint32_t singleTime = micros() - start;
+
+    start = micros();
+    for(int r = 0; r < ROUNDS; r++) { hsv2rgb_rainbow(hsv, batched, n); }
+    uint32_t batchedTime = micros() - start;
+
+    Serial.print(n); Serial.print("\t");
+    Serial.print(singleTime); Serial.print("\t\t");
+    Serial.print(batchedTime); Serial.print("\t\t\t");
+    if(batchedTime) { Serial.print((float)singleTime / batchedTime); } else { Serial.print("-"); }
+    if(memcmp(single, batched, n * sizeof(CRGB))) { Serial.print("\tMISMATCH"); }
+    Serial.println();
+  }
+  Serial.println();
+  delay(5000);
+}
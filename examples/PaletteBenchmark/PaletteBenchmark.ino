@@ -0,0 +1,78 @@
+#include <FastLED.h>
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Palette lookup benchmark
+//
+// Times fill_palette against looking up each led with ColorFromPalette, for 16, 32 and 256 entry
+// palettes, and checks that both give the same colors.  fill_palette looks up runs of leds at a
+// time, with SSSE3/AVX2 or NEON instructions when building for targets that have them, and two
+// color channels to a multiply on other 32 bit parts.
+//
+// No leds need to be connected, the results get printed to the serial port.  Lower MAX_LEDS if
+// your board doesn't have enough memory for the larger sizes (each led takes 6 bytes here).
+//
+//////////////////////////////////////////////////
+
+#if defined(__AVR__)
+#define MAX_LEDS 200
+#else
+#define MAX_LEDS 10000
+#endif
+
+// How many times to fill the leds for each measurement
+#define ROUNDS 20
+
+CRGB single[MAX_LEDS];
+CRGB batched[MAX_LEDS];
+
+CRGBPalette16 palette16 = PartyColors_p;
+CRGBPalette32 palette32 = CRGBPalette32(OceanColors_p);
+CRGBPalette256 palette256 = RainbowColors_p;
+
+const uint16_t sizes[] = { 100, 200, 1000, 5000, 10000 };
+
+template <typename PALETTE>
+void measure(const char *name, const PALETTE& pal) {
+  Serial.print(name); Serial.println(":");
+  for(uint8_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    uint16_t n = sizes[i];
+    if(n > MAX_LEDS) { break; }
+
+    uint32_t start = micros();
+    for(int r = 0; r < ROUNDS; r++) {
+      uint8_t colorIndex = r;
+      for(uint16_t j = 0; j < n; j++) {
+        single[j] = ColorFromPalette(pal, colorIndex, 200, LINEARBLEND);
+        colorIndex += 3;
+      }
+    }
+    uint32_t singleTime = micros() - start;
+
+    start = micros();
+    for(int r = 0; r < ROUNDS; r++) { fill_palette(batched, n, r, 3, pal, 200, LINEARBLEND); }
+    uint32_t batchedTime = micros() - start;
+
+    Serial.print(n); Serial.print("\t");
+    Serial.print(singleTime); Serial.print("\t\t");
+    Serial.print(batchedTime); Serial.print("\t\t\t");
+    if(batchedTime) { Serial.print((float)singleTime / batchedTime); } else { Serial.print("-"); }
+    if(memcmp(single, batched, n * sizeof(CRGB))) { Serial.print("\tMISMATCH"); }
+    Serial.println();
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+}
+
+void loop() {
+  Serial.print("leds\tsingle\t\tbatched\t(us for "); Serial.print(ROUNDS); Serial.println(" runs)\tspeedup");
+  measure("CRGBPalette16", palette16);
+  measure("CRGBPalette32", palette32);
+  measure("CRGBPalette256", palette256);
+  Serial.println();
+  delay(5000);
+}
@@ -0,0 +1,77 @@
+#include <FastLED.h>
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Power estimation benchmark
+//
+// Times calculate_channel_sums, which power limiting uses to add up the color channels of all the
+// leds, against a plain byte at a time loop for a range of strip lengths.  calculate_channel_sums
+// uses SSE2/AVX2, NEON or Cortex M4 DSP instructions when building for targets that have them, and
+// the plain loop everywhere else.
+//
+// No leds need to be connected, the results get printed to the serial port.  Lower MAX_LEDS if
+// your board doesn't have enough memory for the larger sizes (each led takes 3 bytes).
+//
+//////////////////////////////////////////////////
+
+#if defined(__AVR__)
+#define MAX_LEDS 300
+#else
+#define MAX_LEDS 50000
+#endif
+
+// How many times to sum up the leds for each measurement
+#define ROUNDS 100
+
+CRGB leds[MAX_LEDS];
+
+const uint16_t sizes[] = { 100, 300, 1000, 5000, 10000, 20000, 50000 };
+
+// the byte at a time loop, as used before calculate_channel_sums got SIMD versions
+void scalar_channel_sums(const CRGB* ledbuffer, uint16_t numLeds, uint32_t sums[3]) {
+  uint32_t red32 = 0, green32 = 0, blue32 = 0;
+  const uint8_t* p = (const uint8_t*)ledbuffer;
+  while(numLeds--) {
+    red32   += *p++;
+    green32 += *p++;
+    blue32  += *p++;
+  }
+  sums[0] = red32; sums[1] = green32; sums[2] = blue32;
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+
+  random16_set_seed(1234);
+  for(int i = 0; i < MAX_LEDS; i++) {
+    leds[i] = CRGB(random8(), random8(), random8());
+  }
+}
+
+void loop() {
+  Serial.print("leds\tscalar\t\tsimd\t(us for "); Serial.print(ROUNDS); Serial.println(" runs)\tspeedup");
+  for(uint8_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    uint16_t n = sizes[i];
+    if(n > MAX_LEDS) { break; }
+
+    uint32_t scalar[3], simd[3];
+    uint32_t start = micros();
+    for(int r = 0; r < ROUNDS; r++) { scalar_channel_sums(leds, n, scalar); }
+    uint32_t scalarTime = micros() - start;
+
+    start = micros();
+    for(int r = 0; r < ROUNDS; r++) { calculate_channel_sums(leds, n, simd); }
+    uint32_t simdTime = micros() - start;
+
+    Serial.print(n); Serial.print("\t");
+    Serial.print(scalarTime); Serial.print("\t\t");
+    Serial.print(simdTime); Serial.print("\t\t\t");
+    if(simdTime) { Serial.print((float)scalarTime / simdTime); } else { Serial.print("-"); }
+    if(scalar[0] != simd[0] || scalar[1] != simd[1] || scalar[2] != simd[2]) { Serial.print("\tMISMATCH"); }
+    Serial.println();
+  }
+  Serial.println();
+  delay(5000);
+}
@@ -66,4 +66,45 @@
 // This enable much more accurate color control on low brightness settings.
 //#define FASTLED_USE_GLOBAL_BRIGHTNESS 1
 
+// Use this to enable the frame profiler.  FastLED.show() will then keep timing statistics for the
+// refresh rate wait, the power limiting pass and the output of each controller, see CTimingStats,
+// CFastLED::getWaitStats()/getPowerStats()/getShowStats() and CLEDController::getShowStats().
+// This costs a few calls to micros() per controller and frame.
+// #define FASTLED_PROFILE 1
+
+// Use this to let controllers write out their leds through an output table (CLEDController::setOutputTable)
+// or as raw data that is already scaled and in wire order (CLEDController::showRaw, showCapturedFrame).
+// Off by default, as it takes a check for every byte the drivers write out - time the cycle counted
+// clockless drivers don't have to spare - and building output tables pulls in pow.
+#ifndef FASTLED_OUTPUT_BYPASS
+#define FASTLED_OUTPUT_BYPASS 0
+#endif
+
+// Use this to set how many controllers can be registered at the same time
+#ifndef FASTLED_MAX_CONTROLLERS
+#if defined(__AVR__)
+#define FASTLED_MAX_CONTROLLERS 8
+#else
+#define FASTLED_MAX_CONTROLLERS 32
+#endif
+#endif
+
+// Use this to look up the colors of hues at full saturation and value in a 768 byte table, rather
+// than working them out each time.  This speeds up hsv2rgb_rainbow, fill_rainbow and CRGB::setHue.
+// Set it to 1 to keep the table in RAM, or to 2 to keep it in PROGMEM (flash, on AVR).  It is on by
+// default on platforms with RAM to spare.
+#ifndef FASTLED_HUE_TABLE
+#if defined(ESP32) || defined(__MK64FX512__) || defined(__MK66FX1M0__)
+#define FASTLED_HUE_TABLE 1
+#else
+#define FASTLED_HUE_TABLE 0
+#endif
+#endif
+
+// Use this to set how many power zones (e.g. separate power supplies, each with their own power limit)
+// controllers can be assigned to, see CLEDController::setPowerZone.
+#ifndef FASTLED_POWER_ZONES
+#define FASTLED_POWER_ZONES 4
+#endif
+
 #endif
@@ -0,0 +1,73 @@
+#ifndef __INC_FL_PROFILE_H
+#define __INC_FL_PROFILE_H
+
+#include "FastLED.h"
+
+///@file fastled_profile.h
+/// Timing statistics used by the optional frame profiler (see FASTLED_PROFILE in fastled_config.h)
+
+FASTLED_NAMESPACE_BEGIN
+
+#ifndef FASTLED_PROFILE_BUCKETS
+#define FASTLED_PROFILE_BUCKETS 16
+#endif
+
+/// Running statistics for a series of durations, measured in microseconds.  Keeps min/max/average
+/// and a log2 histogram: bucket 0 counts 0µs samples, bucket n counts samples from 2^(n-1) up to
+/// 2^n - 1 µs, and the last bucket also collects everything longer than that.
+class CTimingStats {
+	uint32_t m_nMin;
+	uint32_t m_nMax;
+	uint32_t m_nTotal;
+	uint32_t m_nCount;
+	uint32_t m_nLast;
+	uint16_t m_Histogram[FASTLED_PROFILE_BUCKETS];
+
+public:
+	CTimingStats() { reset(); }
+
+	/// forget all samples
+	void reset() {
+		m_nMin = 0xFFFFFFFF;
+		m_nMax = m_nTotal = m_nCount = m_nLast = 0;
+		for(int i = 0; i < FASTLED_PROFILE_BUCKETS; i++) { m_Histogram[i] = 0; }
+	}
+
+	/// record a sample
+	void add(uint32_t us) {
+		m_nLast = us;
+		if(us < m_nMin) { m_nMin = us; }
+		if(us > m_nMax) { m_nMax = us; }
+
+		// rather than overflowing, halve the totals - that keeps the average intact
+		if((m_nTotal + us) < m_nTotal) { m_nTotal >>= 1; m_nCount >>= 1; }
+		m_nTotal += us;
+		m_nCount++;
+
+		uint8_t bucket = 0;
+		while(us && bucket < (FASTLED_PROFILE_BUCKETS-1)) { us >>= 1; bucket++; }
+		if(m_Histogram[bucket] == 0xFFFF) {
+			for(int i = 0; i < FASTLED_PROFILE_BUCKETS; i++) { m_Histogram[i] >>= 1; }
+		}
+		m_Histogram[bucket]++;
+	}
+
+	/// number of samples the average is taken over
+	uint32_t getCount() const { return m_nCount; }
+	/// shortest sample, 0 if there are no samples
+	uint32_t getMin() const { return m_nCount ? m_nMin : 0; }
+	/// longest sample
+	uint32_t getMax() const { return m_nMax; }
+	/// average of the samples
+	uint32_t getAvg() const { return m_nCount ? (m_nTotal / m_nCount) : 0; }
+	/// the most recent sample
+	uint32_t getLast() const { return m_nLast; }
+	/// number of samples in the given histogram bucket
+	uint16_t getBucket(uint8_t n) const { return (n < FASTLED_PROFILE_BUCKETS) ? m_Histogram[n] : 0; }
+	/// lowest duration, in µs, counted by the given histogram bucket
+	static uint32_t getBucketStart(uint8_t n) { return n ? (1UL << (n-1)) : 0; }
+};
+
+FASTLED_NAMESPACE_END
+
+#endif
@@ -119,8 +119,7 @@ public:
 	#define CLOCK_LO_DELAY delaycycles<(((SPI_SPEED-6) / 4))>();
 
 	// write the BIT'th bit out via spi, setting the data pin then strobing the clcok
-        ALWAYS_INLINE HOT
-	template <uint8_t BIT> inline static void writeBit(uint8_t b) {
+	template <uint8_t BIT> ALWAYS_INLINE HOT inline static void writeBit(uint8_t b) {
 		//cli();
 		if(b & (1 << BIT)) {
 			FastPin<DATA_PIN>::hi();
@@ -295,8 +294,7 @@ public:
 	// write a block of uint8_ts out in groups of three.  len is the total number of uint8_ts to write out.  The template
 	// parameters indicate how many uint8_ts to skip at the beginning of each grouping, as well as a class specifying a per
 	// byte of data modification to be made.  (See DATA_NOP above)
-        NO_INLINE
-	template <uint8_t FLAGS, class D, EOrder RGB_ORDER>  void writePixels(PixelController<RGB_ORDER> pixels) {
+	template <uint8_t FLAGS, class D, EOrder RGB_ORDER> NO_INLINE void writePixels(PixelController<RGB_ORDER> pixels) {
 		select();
 		int len = pixels.mLen;
 
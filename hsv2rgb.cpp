@@ -3,6 +3,27 @@
 
 #include "FastLED.h"
 
+// Pick an implementation for converting arrays with hsv2rgb_rainbow.  The
+// batched versions count on scale8 being the 'fixed' one, which turns the
+// special cases for saturation and value of 0 and 255 into plain math.
+#if defined(FASTLED_HAVE_HSV2RGB_RAINBOW) || (FASTLED_SCALE8_FIXED != 1)
+#define HSV2RGB_RAINBOW_C 1
+#elif defined(__AVX2__)
+#define HSV2RGB_RAINBOW_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#define HSV2RGB_RAINBOW_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HSV2RGB_RAINBOW_NEON 1
+#include <arm_neon.h>
+#elif defined(__ARM_ARCH_7EM__)
+// Cortex M4/M7, single cycle multiplies make the branch-free version pay off
+#define HSV2RGB_RAINBOW_ARM_DSP 1
+#else
+#define HSV2RGB_RAINBOW_C 1
+#endif
+
 FASTLED_NAMESPACE_BEGIN
 
 // Functions to convert HSV colors to RGB colors.
@@ -342,6 +363,49 @@ inline uint32_t shift_right<0, uint32_t>(uint32_t a) { return a; }
 
 
 
+#if FASTLED_HUE_TABLE != 0
+// hue2rgb_rainbow<1> for every hue.  Kept in RAM rather than flash unless
+// asked for, on most parts that's where it gets read from fastest.
+#if FASTLED_HUE_TABLE == 2
+const uint8_t gHueWheel[256][3] FL_PROGMEM = {
+#else
+uint8_t gHueWheel[256][3] = {
+#endif
+    { 255,   0,   0 }, { 253,   2,   0 }, { 250,   5,   0 }, { 247,   8,   0 }, { 244,  11,   0 }, { 242,  13,   0 }, { 239,  16,   0 }, { 236,  19,   0 },  // 0x00
+    { 233,  22,   0 }, { 231,  24,   0 }, { 228,  27,   0 }, { 225,  30,   0 }, { 222,  33,   0 }, { 220,  35,   0 }, { 217,  38,   0 }, { 214,  41,   0 },  // 0x08
+    { 211,  44,   0 }, { 208,  47,   0 }, { 206,  49,   0 }, { 203,  52,   0 }, { 200,  55,   0 }, { 197,  58,   0 }, { 195,  60,   0 }, { 192,  63,   0 },  // 0x10
+    { 189,  66,   0 }, { 186,  69,   0 }, { 184,  71,   0 }, { 181,  74,   0 }, { 178,  77,   0 }, { 175,  80,   0 }, { 173,  82,   0 }, { 170,  85,   0 },  // 0x18
+    { 170,  85,   0 }, { 170,  87,   0 }, { 170,  90,   0 }, { 170,  93,   0 }, { 170,  96,   0 }, { 170,  98,   0 }, { 170, 101,   0 }, { 170, 104,   0 },  // 0x20
+    { 170, 107,   0 }, { 170, 109,   0 }, { 170, 112,   0 }, { 170, 115,   0 }, { 170, 118,   0 }, { 170, 120,   0 }, { 170, 123,   0 }, { 170, 126,   0 },  // 0x28
+    { 170, 129,   0 }, { 170, 132,   0 }, { 170, 134,   0 }, { 170, 137,   0 }, { 170, 140,   0 }, { 170, 143,   0 }, { 170, 145,   0 }, { 170, 148,   0 },  // 0x30
+    { 170, 151,   0 }, { 170, 154,   0 }, { 170, 156,   0 }, { 170, 159,   0 }, { 170, 162,   0 }, { 170, 165,   0 }, { 170, 167,   0 }, { 170, 170,   0 },  // 0x38
+    { 170, 170,   0 }, { 164, 172,   0 }, { 159, 175,   0 }, { 154, 178,   0 }, { 148, 181,   0 }, { 142, 183,   0 }, { 137, 186,   0 }, { 132, 189,   0 },  // 0x40
+    { 126, 192,   0 }, { 120, 194,   0 }, { 115, 197,   0 }, { 110, 200,   0 }, { 104, 203,   0 }, {  98, 205,   0 }, {  93, 208,   0 }, {  88, 211,   0 },  // 0x48
+    {  82, 214,   0 }, {  77, 217,   0 }, {  71, 219,   0 }, {  66, 222,   0 }, {  60, 225,   0 }, {  55, 228,   0 }, {  49, 230,   0 }, {  44, 233,   0 },  // 0x50
+    {  38, 236,   0 }, {  33, 239,   0 }, {  27, 241,   0 }, {  22, 244,   0 }, {  16, 247,   0 }, {  11, 250,   0 }, {   5, 252,   0 }, {   0, 255,   0 },  // 0x58
+    {   0, 255,   0 }, {   0, 253,   2 }, {   0, 250,   5 }, {   0, 247,   8 }, {   0, 244,  11 }, {   0, 242,  13 }, {   0, 239,  16 }, {   0, 236,  19 },  // 0x60
+    {   0, 233,  22 }, {   0, 231,  24 }, {   0, 228,  27 }, {   0, 225,  30 }, {   0, 222,  33 }, {   0, 220,  35 }, {   0, 217,  38 }, {   0, 214,  41 },  // 0x68
+    {   0, 211,  44 }, {   0, 208,  47 }, {   0, 206,  49 }, {   0, 203,  52 }, {   0, 200,  55 }, {   0, 197,  58 }, {   0, 195,  60 }, {   0, 192,  63 },  // 0x70
+    {   0, 189,  66 }, {   0, 186,  69 }, {   0, 184,  71 }, {   0, 181,  74 }, {   0, 178,  77 }, {   0, 175,  80 }, {   0, 173,  82 }, {   0, 170,  85 },  // 0x78
+    {   0, 170,  85 }, {   0, 164,  91 }, {   0, 159,  96 }, {   0, 154, 101 }, {   0, 148, 107 }, {   0, 142, 113 }, {   0, 137, 118 }, {   0, 132, 123 },  // 0x80
+    {   0, 126, 129 }, {   0, 120, 135 }, {   0, 115, 140 }, {   0, 110, 145 }, {   0, 104, 151 }, {   0,  98, 157 }, {   0,  93, 162 }, {   0,  88, 167 },  // 0x88
+    {   0,  82, 173 }, {   0,  77, 178 }, {   0,  71, 184 }, {   0,  66, 189 }, {   0,  60, 195 }, {   0,  55, 200 }, {   0,  49, 206 }, {   0,  44, 211 },  // 0x90
+    {   0,  38, 217 }, {   0,  33, 222 }, {   0,  27, 228 }, {   0,  22, 233 }, {   0,  16, 239 }, {   0,  11, 244 }, {   0,   5, 250 }, {   0,   0, 255 },  // 0x98
+    {   0,   0, 255 }, {   2,   0, 253 }, {   5,   0, 250 }, {   8,   0, 247 }, {  11,   0, 244 }, {  13,   0, 242 }, {  16,   0, 239 }, {  19,   0, 236 },  // 0xA0
+    {  22,   0, 233 }, {  24,   0, 231 }, {  27,   0, 228 }, {  30,   0, 225 }, {  33,   0, 222 }, {  35,   0, 220 }, {  38,   0, 217 }, {  41,   0, 214 },  // 0xA8
+    {  44,   0, 211 }, {  47,   0, 208 }, {  49,   0, 206 }, {  52,   0, 203 }, {  55,   0, 200 }, {  58,   0, 197 }, {  60,   0, 195 }, {  63,   0, 192 },  // 0xB0
+    {  66,   0, 189 }, {  69,   0, 186 }, {  71,   0, 184 }, {  74,   0, 181 }, {  77,   0, 178 }, {  80,   0, 175 }, {  82,   0, 173 }, {  85,   0, 170 },  // 0xB8
+    {  85,   0, 170 }, {  87,   0, 168 }, {  90,   0, 165 }, {  93,   0, 162 }, {  96,   0, 159 }, {  98,   0, 157 }, { 101,   0, 154 }, { 104,   0, 151 },  // 0xC0
+    { 107,   0, 148 }, { 109,   0, 146 }, { 112,   0, 143 }, { 115,   0, 140 }, { 118,   0, 137 }, { 120,   0, 135 }, { 123,   0, 132 }, { 126,   0, 129 },  // 0xC8
+    { 129,   0, 126 }, { 132,   0, 123 }, { 134,   0, 121 }, { 137,   0, 118 }, { 140,   0, 115 }, { 143,   0, 112 }, { 145,   0, 110 }, { 148,   0, 107 },  // 0xD0
+    { 151,   0, 104 }, { 154,   0, 101 }, { 156,   0,  99 }, { 159,   0,  96 }, { 162,   0,  93 }, { 165,   0,  90 }, { 167,   0,  88 }, { 170,   0,  85 },  // 0xD8
+    { 170,   0,  85 }, { 172,   0,  83 }, { 175,   0,  80 }, { 178,   0,  77 }, { 181,   0,  74 }, { 183,   0,  72 }, { 186,   0,  69 }, { 189,   0,  66 },  // 0xE0
+    { 192,   0,  63 }, { 194,   0,  61 }, { 197,   0,  58 }, { 200,   0,  55 }, { 203,   0,  52 }, { 205,   0,  50 }, { 208,   0,  47 }, { 211,   0,  44 },  // 0xE8
+    { 214,   0,  41 }, { 217,   0,  38 }, { 219,   0,  36 }, { 222,   0,  33 }, { 225,   0,  30 }, { 228,   0,  27 }, { 230,   0,  25 }, { 233,   0,  22 },  // 0xF0
+    { 236,   0,  19 }, { 239,   0,  16 }, { 241,   0,  14 }, { 244,   0,  11 }, { 247,   0,   8 }, { 250,   0,   5 }, { 252,   0,   3 }, { 255,   0,   0 }  // 0xF8
+};
+#endif
+
 #ifndef FASTLED_HAVE_HSV2RGB_RAINBOW
 
 // See: https://user-images.githubusercontent.com/2461547/31694367-b9010528-b358-11e7-819a-b65a3ac14c2f.jpg
@@ -456,7 +520,11 @@ inline CRGB hsv2rgb_rainbow( const CHSV& hsv)
 {
     static_assert( GS <= 256, "Invalid hsv2rgb_rainbow parameters" );
 
+#if FASTLED_HUE_TABLE != 0
+    CRGB rgb = (YB == 1) ? hue2rgb_wheel( hsv.hue) : hue2rgb_rainbow< YB >( hsv.hue);
+#else
     CRGB rgb = hue2rgb_rainbow< YB >( hsv.hue);
+#endif
 
     // This is one of the good places to scale the green down,
     // although the client can scale green down as well.
@@ -490,6 +558,9 @@ void hsv2rgb_rainbow( const struct CHSV& hsv, struct CRGB& rgb)
   rgb = hsv2rgb_rainbow<YB,GS>( hsv);
 }
 
+// the default variant is declared in hsv2rgb.h, make sure it gets emitted
+template void hsv2rgb_rainbow<1,256>( const struct CHSV& hsv, struct CRGB& rgb);
+
 #endif // FASTLED_HAVE_HSV2RGB_RAINBOW
 
 void hsv2rgb_raw(const struct CHSV * phsv, struct CRGB * prgb, int numLeds) {
@@ -498,8 +569,181 @@ void hsv2rgb_raw(const struct CHSV * phsv, struct CRGB * prgb, int numLeds) {
     }
 }
 
+#if (HSV2RGB_RAINBOW_SSE2 == 1) || (HSV2RGB_RAINBOW_AVX2 == 1) || (HSV2RGB_RAINBOW_NEON == 1)
+// hsv2rgb_rainbow<1,256> for a whole vector of 16 bit lanes at a time.  Rather
+// than branching on the hue section, every section's colors get computed and
+// the right ones are picked out with masks.  Everything stays below 65536 in
+// 16 bits, so the scale8 math is exact.
+#if HSV2RGB_RAINBOW_AVX2 == 1
+#define HSV_LANES 16
+typedef __m256i hsv_vec;
+#define HSV_SET(x)     _mm256_set1_epi16(x)
+#define HSV_ADD(a,b)   _mm256_add_epi16(a,b)
+#define HSV_SUB(a,b)   _mm256_sub_epi16(a,b)
+#define HSV_MUL(a,b)   _mm256_mullo_epi16(a,b)
+#define HSV_AND(a,b)   _mm256_and_si256(a,b)
+#define HSV_OR(a,b)    _mm256_or_si256(a,b)
+#define HSV_EQ(a,b)    _mm256_cmpeq_epi16(a,b)
+#define HSV_SHL(a,n)   _mm256_slli_epi16(a,n)
+#define HSV_SHR(a,n)   _mm256_srli_epi16(a,n)
+#define HSV_LOAD(p)    _mm256_loadu_si256((const __m256i*)(p))
+#define HSV_STORE(p,x) _mm256_storeu_si256((__m256i*)(p), x)
+#elif HSV2RGB_RAINBOW_SSE2 == 1
+#define HSV_LANES 8
+typedef __m128i hsv_vec;
+#define HSV_SET(x)     _mm_set1_epi16(x)
+#define HSV_ADD(a,b)   _mm_add_epi16(a,b)
+#define HSV_SUB(a,b)   _mm_sub_epi16(a,b)
+#define HSV_MUL(a,b)   _mm_mullo_epi16(a,b)
+#define HSV_AND(a,b)   _mm_and_si128(a,b)
+#define HSV_OR(a,b)    _mm_or_si128(a,b)
+#define HSV_EQ(a,b)    _mm_cmpeq_epi16(a,b)
+#define HSV_SHL(a,n)   _mm_slli_epi16(a,n)
+#define HSV_SHR(a,n)   _mm_srli_epi16(a,n)
+#define HSV_LOAD(p)    _mm_loadu_si128((const __m128i*)(p))
+#define HSV_STORE(p,x) _mm_storeu_si128((__m128i*)(p), x)
+#else
+#define HSV_LANES 8
+typedef uint16x8_t hsv_vec;
+#define HSV_SET(x)     vdupq_n_u16(x)
+#define HSV_ADD(a,b)   vaddq_u16(a,b)
+#define HSV_SUB(a,b)   vsubq_u16(a,b)
+#define HSV_MUL(a,b)   vmulq_u16(a,b)
+#define HSV_AND(a,b)   vandq_u16(a,b)
+#define HSV_OR(a,b)    vorrq_u16(a,b)
+#define HSV_EQ(a,b)    vceqq_u16(a,b)
+#define HSV_SHL(a,n)   vshlq_n_u16(a,n)
+#define HSV_SHR(a,n)   vshrq_n_u16(a,n)
+#endif
+
+static inline void hsv2rgb_rainbow_lanes( hsv_vec hue, hsv_vec sat, hsv_vec val, hsv_vec& r, hsv_vec& g, hsv_vec& b)
+{
+    const hsv_vec ff = HSV_SET(0xFF);
+    const hsv_vec c85 = HSV_SET(85);
+    const hsv_vec c170 = HSV_SET(170);
+    const hsv_vec one = HSV_SET(1);
+
+    // offset8 = abcdeabc for hue = ...abcde, third = scale8( offset8, 85)
+    const hsv_vec offset = HSV_AND(hue, HSV_SET(0x1F));
+    const hsv_vec offset8 = HSV_OR(HSV_SHL(offset, 3), HSV_SHR(offset, 2));
+    const hsv_vec third = HSV_SHR(HSV_MUL(offset8, HSV_SET(86)), 8);
+
+    const hsv_vec section = HSV_SHR(hue, 5);
+    hsv_vec m[8];
+    for(int i = 0; i < 8; i++) { m[i] = HSV_EQ(section, HSV_SET(i)); }
+
+    const hsv_vec nthird = HSV_SUB(ff, third);             // 255 - third
+    const hsv_vec t85 = HSV_ADD(c85, third);               // 85 + third
+    const hsv_vec t170 = HSV_ADD(c170, third);             // 170 + third
+    const hsv_vec t170o = HSV_SUB(t170, offset8);          // 170 + third - offset8
+
+    r = HSV_OR(HSV_OR(HSV_AND(m[0], nthird), HSV_AND(m[1], c170)),
+        HSV_OR(HSV_OR(HSV_AND(m[2], t170o), HSV_AND(m[5], third)),
+               HSV_OR(HSV_AND(m[6], t85), HSV_AND(m[7], t170))));
+    g = HSV_OR(HSV_OR(HSV_AND(m[0], third), HSV_AND(m[1], t85)),
+        HSV_OR(HSV_OR(HSV_AND(m[2], t170), HSV_AND(m[3], nthird)), HSV_AND(m[4], t170o)));
+    b = HSV_OR(HSV_OR(HSV_AND(m[3], third), HSV_AND(m[4], HSV_SUB(ff, t170o))),
+        HSV_OR(HSV_OR(HSV_AND(m[5], nthird), HSV_AND(m[6], HSV_SUB(ff, t85))), HSV_AND(m[7], HSV_SUB(ff, t170))));
+
+    // rgb.nscale8( sat).addRaw( dim8_raw( 255 - sat)), which also covers sat of 0 and 255
+    const hsv_vec desat = HSV_SUB(ff, sat);
+    const hsv_vec floor = HSV_SHR(HSV_MUL(desat, HSV_ADD(desat, one)), 8);
+    const hsv_vec sat1 = HSV_ADD(sat, one);
+    r = HSV_AND(HSV_ADD(HSV_SHR(HSV_MUL(HSV_AND(r, ff), sat1), 8), floor), ff);
+    g = HSV_AND(HSV_ADD(HSV_SHR(HSV_MUL(HSV_AND(g, ff), sat1), 8), floor), ff);
+    b = HSV_AND(HSV_ADD(HSV_SHR(HSV_MUL(HSV_AND(b, ff), sat1), 8), floor), ff);
+
+    // rgb.nscale8( dim8_raw( val)), which also covers val of 0 and 255
+    const hsv_vec val1 = HSV_ADD(HSV_SHR(HSV_MUL(val, HSV_ADD(val, one)), 8), one);
+    r = HSV_SHR(HSV_MUL(r, val1), 8);
+    g = HSV_SHR(HSV_MUL(g, val1), 8);
+    b = HSV_SHR(HSV_MUL(b, val1), 8);
+}
+#endif
+
+#if HSV2RGB_RAINBOW_ARM_DSP == 1
+// Per section, the base value and the signs of third and offset8 making up
+// each channel of hue2rgb_rainbow<1>, see the sections there
+struct hue_section_t { uint8_t base[3]; int8_t third[3]; int8_t offset8[3]; };
+static const hue_section_t gHueSections[8] = {
+    { { 255,   0,   0 }, { -1,  1,  0 }, {  0,  0, 0 } },  // Red -> Orange
+    { { 170,  85,   0 }, {  0,  1,  0 }, {  0,  0, 0 } },  // Orange -> Yellow
+    { { 170, 170,   0 }, {  1,  1,  0 }, { -1,  0, 0 } },  // Yellow -> Green
+    { {   0, 255,   0 }, {  0, -1,  1 }, {  0,  0, 0 } },  // Green -> Aqua
+    { {   0, 170,  85 }, {  0,  1, -1 }, {  0, -1, 1 } },  // Aqua -> Blue
+    { {   0,   0, 255 }, {  1,  0, -1 }, {  0,  0, 0 } },  // Blue -> Purple
+    { {  85,   0, 170 }, {  1,  0, -1 }, {  0,  0, 0 } },  // Purple -> Pink
+    { { 170,   0,  85 }, {  1,  0, -1 }, {  0,  0, 0 } }   // Pink -> Red
+};
+#endif
+
 void hsv2rgb_rainbow( const struct CHSV* phsv, struct CRGB * prgb, int numLeds) {
-    for(int i = 0; i < numLeds; i++) {
+    int i = 0;
+
+#if (HSV2RGB_RAINBOW_SSE2 == 1) || (HSV2RGB_RAINBOW_AVX2 == 1)
+    // 2 vectors at a time, the channels get split apart into 16 bit lanes
+    // through buffers on the stack and put back together the same way
+    uint16_t h[2 * HSV_LANES], s[2 * HSV_LANES], v[2 * HSV_LANES];
+    uint16_t rgb[3][2 * HSV_LANES];
+    for( ; i + (2 * HSV_LANES) <= numLeds; i += (2 * HSV_LANES)) {
+        const CHSV* src = phsv + i;
+        for(int j = 0; j < 2 * HSV_LANES; j++) {
+            h[j] = src[j].hue;
+            s[j] = src[j].sat;
+            v[j] = src[j].val;
+        }
+        for(int j = 0; j < 2 * HSV_LANES; j += HSV_LANES) {
+            hsv_vec r, g, b;
+            hsv2rgb_rainbow_lanes( HSV_LOAD(h + j), HSV_LOAD(s + j), HSV_LOAD(v + j), r, g, b);
+            HSV_STORE(rgb[0] + j, r);
+            HSV_STORE(rgb[1] + j, g);
+            HSV_STORE(rgb[2] + j, b);
+        }
+        CRGB* dst = prgb + i;
+        for(int j = 0; j < 2 * HSV_LANES; j++) {
+            dst[j].r = rgb[0][j];
+            dst[j].g = rgb[1][j];
+            dst[j].b = rgb[2][j];
+        }
+    }
+#elif HSV2RGB_RAINBOW_NEON == 1
+    // 16 leds at a time, vld3/vst3 split the channels apart and put them
+    // back together
+    for( ; i + 16 <= numLeds; i += 16) {
+        uint8x16x3_t hsv = vld3q_u8((const uint8_t*)(phsv + i));
+        uint16x8_t r0, g0, b0, r1, g1, b1;
+        hsv2rgb_rainbow_lanes( vmovl_u8(vget_low_u8(hsv.val[0])), vmovl_u8(vget_low_u8(hsv.val[1])),
+                               vmovl_u8(vget_low_u8(hsv.val[2])), r0, g0, b0);
+        hsv2rgb_rainbow_lanes( vmovl_u8(vget_high_u8(hsv.val[0])), vmovl_u8(vget_high_u8(hsv.val[1])),
+                               vmovl_u8(vget_high_u8(hsv.val[2])), r1, g1, b1);
+        uint8x16x3_t rgb;
+        rgb.val[0] = vcombine_u8(vmovn_u16(r0), vmovn_u16(r1));
+        rgb.val[1] = vcombine_u8(vmovn_u16(g0), vmovn_u16(g1));
+        rgb.val[2] = vcombine_u8(vmovn_u16(b0), vmovn_u16(b1));
+        vst3q_u8((uint8_t*)(prgb + i), rgb);
+    }
+#elif HSV2RGB_RAINBOW_ARM_DSP == 1
+    // one led at a time, but without branches: the hue section picks the
+    // makeup of each channel out of gHueSections
+    for( ; i < numLeds; i++) {
+        const CHSV& hsv = phsv[i];
+        const uint32_t offset = hsv.hue & 0x1F;
+        const int32_t offset8 = (offset << 3) | (offset >> 2);
+        const int32_t third = (offset8 * 86) >> 8;
+        const hue_section_t& sec = gHueSections[hsv.hue >> 5];
+        const uint32_t sat1 = hsv.sat + 1;
+        const uint32_t desat = 255 - hsv.sat;
+        const uint32_t floor = (desat * (desat + 1)) >> 8;
+        const uint32_t val1 = ((hsv.val * (hsv.val + 1)) >> 8) + 1;
+        for(int c = 0; c < 3; c++) {
+            uint32_t x = (uint8_t)(sec.base[c] + (sec.third[c] * third) + (sec.offset8[c] * offset8));
+            x = (uint8_t)(((x * sat1) >> 8) + floor);
+            prgb[i].raw[c] = (x * val1) >> 8;
+        }
+    }
+#endif
+
+    for( ; i < numLeds; i++) {
         hsv2rgb_rainbow(phsv[i], prgb[i]);
     }
 }
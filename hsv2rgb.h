@@ -22,9 +22,33 @@ inline void hsv2rgb_rainbow( const CHSV& hsv, CRGB& rgb) {
   hsv2rgb_rainbow<1,256>(hsv, rgb);
 }
 
+// converts a whole array at once, a batch of leds at a time on targets with
+// SIMD instructions; gives exactly the same colors as one led at a time
 void hsv2rgb_rainbow( const struct CHSV* phsv, struct CRGB * prgb, int numLeds);
 #define HUE_MAX_RAINBOW 255
 
+#if FASTLED_HUE_TABLE != 0
+// gHueWheel - the colors hsv2rgb_rainbow gives for each hue at full
+//             saturation and value, see FASTLED_HUE_TABLE
+#if FASTLED_HUE_TABLE == 2
+extern const uint8_t gHueWheel[256][3] FL_PROGMEM;
+#else
+extern uint8_t gHueWheel[256][3];
+#endif
+
+// hue2rgb_wheel - the same as hsv2rgb_rainbow( CHSV( hue, 255, 255)),
+//                 looked up in gHueWheel
+ALWAYS_INLINE
+inline CRGB hue2rgb_wheel( uint8_t hue) {
+  const uint8_t* p = gHueWheel[hue];
+#if FASTLED_HUE_TABLE == 2
+  return CRGB( FL_PGM_READ_BYTE_NEAR(p), FL_PGM_READ_BYTE_NEAR(p + 1), FL_PGM_READ_BYTE_NEAR(p + 2));
+#else
+  return CRGB( p[0], p[1], p[2]);
+#endif
+}
+#endif
+
 
 // hsv2rgb_spectrum - convert a hue, saturation, and value to RGB
 //                    using a mathematically straight spectrum (vs
@@ -18,6 +18,9 @@ struct CHSV;
 /// Forward declaration of hsv2rgb_rainbow here,
 /// to avoid circular dependencies.
 inline void hsv2rgb_rainbow( const CHSV& hsv, CRGB& rgb);
+#if FASTLED_HUE_TABLE != 0
+inline CRGB hue2rgb_wheel( uint8_t hue);
+#endif
 //extern CRGB hsv2rgb_rainbow( const CHSV& hsv);
 
 /// Representation of an HSV pixel (hue, saturation, value (aka brightness)).
@@ -219,7 +222,11 @@ struct CRGB {
     /// allow assignment from just a Hue, saturation and value automatically at max.
 	inline CRGB& setHue (uint8_t hue) __attribute__((always_inline))
     {
+#if FASTLED_HUE_TABLE != 0
+        *this = hue2rgb_wheel(hue);
+#else
         *this = CHSV(hue, 255, 255);
+#endif
         return *this;
     }
 
@@ -907,6 +914,85 @@ inline CRGB operator%( const CRGB& p1, fract8 d)
 }
 
 
+/// Representation of an RGB pixel with 16 bits per channel, for effects that need more precision than 8 bits
+/// give - deep fades, slow blends, gamma correction.  Controllers write it out through CLEDController::setLeds16,
+/// which brings it down to the bit depth of the chipset in the same pass as the brightness scaling, dithering
+/// the bits that get dropped.
+struct CRGB16 {
+	union {
+		struct {
+            union {
+                uint16_t r;
+                uint16_t red;
+            };
+            union {
+                uint16_t g;
+                uint16_t green;
+            };
+            union {
+                uint16_t b;
+                uint16_t blue;
+            };
+        };
+		uint16_t raw[3];
+	};
+
+    /// Array access operator to index into the crgb16 object
+	inline uint16_t& operator[] (uint8_t x) __attribute__((always_inline))
+    {
+        return raw[x];
+    }
+
+    /// Array access operator to index into the crgb16 object
+    inline const uint16_t& operator[] (uint8_t x) const __attribute__((always_inline))
+    {
+        return raw[x];
+    }
+
+    // default values are UNINITIALIZED
+    inline CRGB16() __attribute__((always_inline))
+    {
+    }
+
+    /// allow construction from R, G, B
+    inline CRGB16( uint16_t ir, uint16_t ig, uint16_t ib)  __attribute__((always_inline))
+        : r(ir), g(ig), b(ib)
+    {
+    }
+
+    /// allow construction from an 8 bit CRGB, stretching each channel to the full 16 bit range (0xFF becomes 0xFFFF)
+    inline CRGB16( const CRGB& rhs) __attribute__((always_inline))
+        : r(rhs.r * 257), g(rhs.g * 257), b(rhs.b * 257)
+    {
+    }
+
+    /// get the top 8 bits of each channel as a CRGB, without rounding or dithering
+    inline CRGB toCRGB() const __attribute__((always_inline))
+    {
+        return CRGB(r >> 8, g >> 8, b >> 8);
+    }
+
+    /// scale down a RGB to N 65536ths of it's current brightness
+    inline CRGB16& nscale16 (fract16 scaledown ) __attribute__((always_inline))
+    {
+        r = scale16( r, scaledown);
+        g = scale16( g, scaledown);
+        b = scale16( b, scaledown);
+        return *this;
+    }
+};
+
+inline __attribute__((always_inline)) bool operator== (const CRGB16& lhs, const CRGB16& rhs)
+{
+    return (lhs.r == rhs.r) && (lhs.g == rhs.g) && (lhs.b == rhs.b);
+}
+
+inline __attribute__((always_inline)) bool operator!= (const CRGB16& lhs, const CRGB16& rhs)
+{
+    return !(lhs == rhs);
+}
+
+
 
 /// RGB orderings, used when instantiating controllers to determine what
 /// order the controller should send RGB data out in, RGB being the default
@@ -29,6 +29,9 @@
 #include "platforms/esp/32/fastled_esp32.h"
 #elif defined(__STM8__)
 #include "platforms/stm8/fastled_stm8.h"
+#elif defined(FASTLED_POSIX) || ((defined(__linux__) || defined(__unix__) || defined(__APPLE__)) && !defined(ARDUINO))
+// Native Linux/POSIX host build
+#include "platforms/posix/fastled_posix.h"
 #else
 // AVR platforms
 #include "platforms/avr/fastled_avr.h"
@@ -57,6 +57,10 @@ public:
     pocto->show();
   }
 
+  // the octows2811 dma runs in the background, reading from its own copy of the frame
+  virtual bool isBusy() { return pocto && pocto->busy(); }
+  virtual void waitForShow() { while(isBusy()); }
+
 };
 
 FASTLED_NAMESPACE_END
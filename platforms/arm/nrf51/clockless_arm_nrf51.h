@@ -34,6 +34,8 @@ public:
   }
 
 	virtual uint16_t getMaxRefreshRate() const { return 400; }
+	// dithering and scaling happen in asm, which doesn't know about raw data
+	virtual bool canShowRaw() const { return false; }
 
   virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
     mWait.wait();
@@ -27,11 +27,16 @@
  * Since the RMT device only has 8 channels, we need a strategy to
  * allow more than 8 LED controllers. Our driver assigns controllers
  * to channels on the fly, queuing up controllers as necessary until a
- * channel is free. The main showPixels routine just fires off the
- * first 8 controllers; the interrupt handler starts new controllers
- * asynchronously as previous ones finish. So, for example, it can
- * send the data for 8 controllers simultaneously, but 16 controllers
- * would take approximately twice as much time.
+ * channel is free. The showPixels routine just queues up each
+ * controller; once FastLED has handed out the whole frame, endShow
+ * fires off the first 8 controllers and the interrupt handler starts
+ * new controllers asynchronously as previous ones finish. So, for
+ * example, it can send the data for 8 controllers simultaneously, but
+ * 16 controllers would take approximately twice as much time.
+ *
+ * Sending happens in the background: FastLED.showAsync() returns right
+ * away, and the next frame only waits for the previous one to finish
+ * once it gets to the first showPixels call.
  *
  * There is a #define that allows a program to control the total
  * number of channels that the driver is allowed to use. It defaults
@@ -40,6 +45,23 @@
  *
  *     #define FASTLED_RMT_MAX_CHANNELS 1
  *
+ * OUTPUT ON THE OTHER CORE
+ *
+ * Refilling the RMT buffers takes an interrupt for every 4 bytes
+ * sent on each channel, which eats into the time left for rendering
+ * on the core that shows the leds. To move the output over to the
+ * other core, pick the core for it before you include FastLED.h:
+ *
+ *      #define FASTLED_ESP32_OUTPUT_CORE 0
+ *
+ * A task pinned to that core then starts the channels and takes the
+ * refill interrupts, while FastLED.showAsync() returns as soon as the
+ * frame is handed over, leaving the calling core to render the next
+ * frame while this one is sent. With FASTLED_PROFILE set, the time
+ * each frame took to send and how much of it overlapped with work on
+ * the calling core are kept in esp32_rmt_send_stats() and
+ * esp32_rmt_overlap_stats().
+ *
  * OTHER RMT APPLICATIONS
  *
  * The default FastLED driver takes over control of the RMT interrupt
@@ -149,13 +171,15 @@ __attribute__ ((always_inline)) inline static uint32_t __clock_cycles() {
 #define FASTLED_RMT_MAX_CHANNELS 8
 #endif
 
-// -- Array of all controllers
+// -- Array of the controllers in the frame being sent
 static CLEDController * gControllers[FASTLED_RMT_MAX_CONTROLLERS];
 
 // -- Current set of active controllers, indexed by the RMT
 //    channel assigned to them.
 static CLEDController * gOnChannel[FASTLED_RMT_MAX_CHANNELS];
 
+// -- gNumControllers is the number of controllers in the frame being
+//    sent, gNumStarted the number queued up for the next one
 static int gNumControllers = 0;
 static int gNumStarted = 0;
 static int gNumDone = 0;
@@ -169,6 +193,29 @@ static xSemaphoreHandle gTX_sem = NULL;
 
 static bool gInitialized = false;
 
+#ifdef FASTLED_ESP32_OUTPUT_CORE
+// -- Task starting the channels and taking the RMT interrupts on the
+//    output core
+static TaskHandle_t gOutputTask = NULL;
+#endif
+
+#if FASTLED_PROFILE == 1
+// -- When sending the last frame started and finished, and how long
+//    the calling core spent blocked waiting for it
+static uint32_t gSendStart = 0;
+static volatile uint32_t gSendEnd = 0;
+static uint32_t gBlocked = 0;
+static bool gSending = false;
+static CTimingStats gSendStats;
+static CTimingStats gOverlapStats;
+
+// -- Time, in µs, it took to send each frame
+inline CTimingStats & esp32_rmt_send_stats() { return gSendStats; }
+// -- Time, in µs, of each frame's sending that overlapped with work on
+//    the calling core, rather than it waiting for the frame to finish
+inline CTimingStats & esp32_rmt_overlap_stats() { return gOverlapStats; }
+#endif
+
 template <int DATA_PIN, int T1, int T2, int T3, EOrder RGB_ORDER = RGB, int XTRA0 = 0, bool FLIP = false, int WAIT_TIME = 5>
 class ClocklessController : public CPixelLEDController<RGB_ORDER>
 {
@@ -188,13 +235,15 @@ class ClocklessController : public CPixelLEDController<RGB_ORDER>
     // -- State information for keeping track of where we are in the pixel data
     uint8_t *      mPixelData = NULL;
     int            mSize = 0;
+    int            mPixelCapacity = 0;
     int            mCurByte;
     uint16_t       mCurPulse;
 
     // -- Buffer to hold all of the pulses. For the version that uses
     //    the RMT driver built into the ESP core.
-    rmt_item32_t * mBuffer;
+    rmt_item32_t * mBuffer = NULL;
     uint16_t       mBufferSize;
+    int            mBufferCapacity = 0;
 
 public:
 
@@ -216,16 +265,129 @@ public:
         mZero.level1 = 0;
         mZero.duration1 = TO_RMT_CYCLES(T2 + T3);
 
-        gControllers[gNumControllers] = this;
-        gNumControllers++;
-
         mPin = gpio_num_t(DATA_PIN);
     }
 
     virtual uint16_t getMaxRefreshRate() const { return 400; }
 
+    // -- Start sending the frame
+    //    Every controller gets this call once all of them were shown,
+    //    the first one starts sending all the queued up controllers.
+    virtual void endShow()
+    {
+        if (gNumStarted == 0) return;
+
+        gNumControllers = gNumStarted;
+        gNumStarted = 0;
+        gNumDone = 0;
+        gNext = 0;
+
+#ifdef FASTLED_ESP32_OUTPUT_CORE
+        xTaskNotifyGive(gOutputTask);
+#else
+        startChannels();
+#endif
+    }
+
+    // -- Is a frame still being sent?
+    virtual bool isBusy()
+    {
+        if (gTX_sem == NULL || gNumStarted != 0) return false;
+        if (xSemaphoreTake(gTX_sem, 0) == pdTRUE) {
+            xSemaphoreGive(gTX_sem);
+            return false;
+        }
+        return true;
+    }
+
+    // -- Wait for the frame being sent to finish
+    virtual void waitForShow()
+    {
+        if (gTX_sem == NULL || gNumStarted != 0) return;
+        takeTXSemaphore();
+        xSemaphoreGive(gTX_sem);
+    }
+
+    // -- Stop being shown before the buffers go away
+    virtual ~ClocklessController() { CLEDController::unregisterController(); }
+
+    // -- Free the pixel and pulse buffers
+    //    Only called once the frame is sent, so neither is in use.
+    //    Channels get assigned to the controllers shown each frame,
+    //    so there is nothing else to undo.
+    virtual void freeBuffers()
+    {
+        if (mPixelData != NULL) free(mPixelData);
+        mPixelData = NULL;
+        mSize = 0;
+        mPixelCapacity = 0;
+        if (mBuffer != NULL) free(mBuffer);
+        mBuffer = NULL;
+        mBufferCapacity = 0;
+    }
+
 protected:
 
+    // -- Wait for the frame being sent to finish, and take the semaphore
+    //    guarding the buffers it uses. With the profiler on, this is
+    //    where the stats for that frame get added up.
+    static void takeTXSemaphore()
+    {
+#if FASTLED_PROFILE == 1
+        uint32_t start = micros();
+        xSemaphoreTake(gTX_sem, portMAX_DELAY);
+        gBlocked += micros() - start;
+        if (gSending) {
+            uint32_t send = gSendEnd - gSendStart;
+            gSendStats.add(send);
+            gOverlapStats.add((send > gBlocked) ? (send - gBlocked) : 0);
+            gSending = false;
+            gBlocked = 0;
+        }
+#else
+        xSemaphoreTake(gTX_sem, portMAX_DELAY);
+#endif
+    }
+
+    // -- Fill all the available channels, the interrupt handler will
+    //    keep refilling the RMT buffers and starting the remaining
+    //    controllers until it is all sent; then it gives the semaphore
+    //    back.
+    static void startChannels()
+    {
+#if FASTLED_PROFILE == 1
+        gSendStart = micros();
+        gBlocked = 0;
+        gSending = true;
+#endif
+        int channel = 0;
+        while (channel < FASTLED_RMT_MAX_CHANNELS && gNext < gNumControllers) {
+            startNext(channel);
+            channel++;
+        }
+    }
+
+#ifdef FASTLED_ESP32_OUTPUT_CORE
+    // -- The output task, pinned to FASTLED_ESP32_OUTPUT_CORE. The RMT
+    //    interrupt gets allocated from here, so that it also runs on
+    //    the output core: our own handler, or the one the built-in
+    //    driver allocates when it gets installed.
+    static void outputTask(void *arg)
+    {
+        if (FASTLED_RMT_BUILTIN_DRIVER) {
+            for (int i = 0; i < FASTLED_RMT_MAX_CHANNELS; i++)
+                rmt_driver_install(rmt_channel_t(i), 0, 0);
+        } else {
+            esp_intr_alloc(ETS_RMT_INTR_SOURCE, 0, interruptHandler, 0, &gRMT_intr_handle);
+        }
+
+        for (;;) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            startChannels();
+        }
+    }
+#endif
+
     void initRMT()
     {
         // -- Only need to do this once
@@ -251,7 +413,10 @@ protected:
             rmt_config(&rmt_tx);
 
             if (FASTLED_RMT_BUILTIN_DRIVER) {
+#ifndef FASTLED_ESP32_OUTPUT_CORE
+                // -- Otherwise the output task installs the driver
                 rmt_driver_install(rmt_channel_t(i), 0, 0);
+#endif
             } else {
                 // -- Set up the RMT to send 1/2 of the pulse buffer and then
                 //    generate an interrupt. When we get this interrupt we
@@ -266,6 +431,15 @@ protected:
             xSemaphoreGive(gTX_sem);
         }
                 
+#ifdef FASTLED_ESP32_OUTPUT_CORE
+        // -- Start the output task, which allocates the interrupt on its
+        //    own core. It runs at a higher priority than the caller, so
+        //    refills don't get held up by rendering on that core. The
+        //    stack leaves room for the ESP-IDF driver calls made from
+        //    it (rmt_driver_install and rmt_write_items).
+        if (gOutputTask == NULL)
+            xTaskCreatePinnedToCore(outputTask, "FastLED", 4096, NULL, configMAX_PRIORITIES - 1, &gOutputTask, FASTLED_ESP32_OUTPUT_CORE);
+#else
         if ( ! FASTLED_RMT_BUILTIN_DRIVER) {
             // -- Allocate the interrupt if we have not done so yet. This
             //    interrupt handler must work for all different kinds of
@@ -274,6 +448,7 @@ protected:
             if (gRMT_intr_handle == NULL)
                 esp_intr_alloc(ETS_RMT_INTR_SOURCE, 0, interruptHandler, 0, &gRMT_intr_handle);
         }
+#endif
 
         gInitialized = true;
     }
@@ -283,9 +458,11 @@ protected:
     virtual void showPixels(PixelController<RGB_ORDER> & pixels)
     {
         if (gNumStarted == 0) {
-            // -- First controller: make sure everything is set up
+            // -- First controller: make sure everything is set up, and
+            //    wait for the previous frame to be sent before touching
+            //    any of the buffers it uses
             initRMT();
-            xSemaphoreTake(gTX_sem, portMAX_DELAY);
+            takeTXSemaphore();
         }
 
         // -- Initialize the local state, save a pointer to the pixel
@@ -300,32 +477,16 @@ protected:
         else
             copyPixelData(pixels);
 
-        // -- Keep track of the number of strips we've seen
-        gNumStarted++;
-
-        // -- The last call to showPixels is the one responsible for doing
-        //    all of the actual worl
-        if (gNumStarted == gNumControllers) {
-            gNext = 0;
-
-            // -- First, fill all the available channels
-            int channel = 0;
-            while (channel < FASTLED_RMT_MAX_CHANNELS && gNext < gNumControllers) {
-                startNext(channel);
-                channel++;
-            }
-
-            // -- Wait here while the rest of the data is sent. The interrupt handler
-            //    will keep refilling the RMT buffers until it is all sent; then it
-            //    gives the semaphore back.
-            xSemaphoreTake(gTX_sem, portMAX_DELAY);
-            xSemaphoreGive(gTX_sem);
-
-            // -- Reset the counters
-            gNumStarted = 0;
-            gNumDone = 0;
-            gNext = 0;
+        // -- Queue up this strip, endShow starts sending them all. Only
+        //    the strips shown this frame are queued, so controllers that
+        //    skip unchanged frames don't hold up the others.
+        if (gNumStarted < FASTLED_RMT_MAX_CONTROLLERS) {
+            gControllers[gNumStarted++] = this;
         }
+
+        // -- Shown on its own (controller.showLeds() rather than
+        //    FastLED.show()), nobody else is going to call endShow
+        if ( ! CLEDController::inShow()) endShow();
     }
 
     // -- Copy pixel data
@@ -336,12 +497,15 @@ protected:
     {
         // -- Make sure we have a buffer of the right size
         //    (3 bytes per pixel)
+        //    The buffer only grows, frames can be shorter than the
+        //    strip (raw data, resized controllers).
         int size_needed = pixels.size() * 3;
-        if (size_needed > mSize) {
+        if (size_needed > mPixelCapacity) {
             if (mPixelData != NULL) free(mPixelData);
-            mSize = size_needed;
-            mPixelData = (uint8_t *) malloc( mSize);
+            mPixelCapacity = size_needed;
+            mPixelData = (uint8_t *) malloc( mPixelCapacity);
         }
+        mSize = size_needed;
 
         // -- Cycle through the R,G, and B values in the right order,
         //    storing the resulting raw pixel data in the buffer.
@@ -352,6 +516,7 @@ protected:
             mPixelData[cur++] = pixels.loadAndScale2();
             pixels.advanceData();
             pixels.stepDithering();
+            pixels.stepBayerDithering();
         }
     }
 
@@ -365,8 +530,11 @@ protected:
         //    Requires a large buffer
         mBufferSize = pixels.size() * 3 * 8;
 
-        if (mBuffer == NULL) {
-            mBuffer = (rmt_item32_t *) calloc( mBufferSize, sizeof(rmt_item32_t));
+        if (mBufferSize > mBufferCapacity) {
+            // -- The strip grew (or this is the first frame)
+            if (mBuffer != NULL) free(mBuffer);
+            mBufferCapacity = mBufferSize;
+            mBuffer = (rmt_item32_t *) calloc( mBufferCapacity, sizeof(rmt_item32_t));
         }
 
         // -- Cycle through the R,G, and B values in the right order,
@@ -383,6 +551,7 @@ protected:
             convertByte(byteval);
             pixels.advanceData();
             pixels.stepDithering();
+            pixels.stepBayerDithering();
         }
 
         mBuffer[mCurPulse-1].duration1 = RMT_RESET_DURATION;
@@ -475,6 +644,9 @@ protected:
 
         if (gNumDone == gNumControllers) {
             // -- If this is the last controller, signal that we are all done
+#if FASTLED_PROFILE == 1
+            gSendEnd = micros();
+#endif
             xSemaphoreGiveFromISR(gTX_sem, &HPTaskAwoken);
             if(HPTaskAwoken == pdTRUE) portYIELD_FROM_ISR();
         } else {
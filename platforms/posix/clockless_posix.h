@@ -0,0 +1,39 @@
+#ifndef __INC_CLOCKLESS_POSIX_H
+#define __INC_CLOCKLESS_POSIX_H
+
+FASTLED_NAMESPACE_BEGIN
+
+#define FASTLED_HAS_CLOCKLESS 1
+
+/// Clockless controller for the posix platform.  Instead of generating the timed bit stream, the
+/// scaled, dithered and reordered bytes are captured by the sink for the data pin (see sink_posix.h).
+/// The timing parameters are accepted so that every clockless chipset definition works unchanged.
+template <int DATA_PIN, int T1, int T2, int T3, EOrder RGB_ORDER = RGB, int XTRA0 = 0, bool FLIP = false, int WAIT_TIME = 50>
+class ClocklessController : public CPixelLEDController<RGB_ORDER> {
+public:
+	virtual void init() {
+		FastPin<DATA_PIN>::setOutput();
+	}
+
+	virtual uint16_t getMaxRefreshRate() const { return 400; }
+
+protected:
+
+	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
+		CPosixLEDSink & sink = posixSink(DATA_PIN);
+		sink.begin(pixels.size() * 3);
+		while(pixels.has(1)) {
+			sink.write(pixels.loadAndScale0());
+			sink.write(pixels.loadAndScale1());
+			sink.write(pixels.loadAndScale2());
+			pixels.advanceData();
+			pixels.stepDithering();
+			pixels.stepBayerDithering();
+		}
+		sink.end();
+	}
+};
+
+FASTLED_NAMESPACE_END
+
+#endif
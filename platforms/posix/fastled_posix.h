@@ -0,0 +1,9 @@
+#ifndef __INC_FASTLED_POSIX_H
+#define __INC_FASTLED_POSIX_H
+
+#include "sink_posix.h"
+#include "fastpin_posix.h"
+#include "fastspi_posix.h"
+#include "clockless_posix.h"
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef __INC_FASTPIN_POSIX_H
+#define __INC_FASTPIN_POSIX_H
+
+FASTLED_NAMESPACE_BEGIN
+
+/// Pin class for the posix platform.  Each pin is backed by a 32 bit variable standing in for its
+/// port register, so pin twiddling code runs (and can be observed) on the host.
+template<uint8_t PIN> class _POSIXPIN {
+public:
+	typedef volatile RwReg * port_ptr_t;
+	typedef RwReg port_t;
+
+	inline static port_ptr_t port() __attribute__ ((always_inline)) { static RwReg reg = 0; return &reg; }
+	inline static port_t mask() __attribute__ ((always_inline)) { return 1; }
+
+	inline static void setOutput() { }
+	inline static void setInput() { }
+
+	inline static void hi() __attribute__ ((always_inline)) { *port() |= mask(); }
+	inline static void lo() __attribute__ ((always_inline)) { *port() &= ~mask(); }
+	inline static void set(register port_t val) __attribute__ ((always_inline)) { *port() = val; }
+
+	inline static void strobe() __attribute__ ((always_inline)) { toggle(); toggle(); }
+	inline static void toggle() __attribute__ ((always_inline)) { *port() ^= mask(); }
+
+	inline static void hi(register port_ptr_t port) __attribute__ ((always_inline)) { *port |= mask(); }
+	inline static void lo(register port_ptr_t port) __attribute__ ((always_inline)) { *port &= ~mask(); }
+	inline static void fastset(register port_ptr_t port, register port_t val) __attribute__ ((always_inline)) { *port = val; }
+
+	inline static port_t hival() __attribute__ ((always_inline)) { return *port() | mask(); }
+	inline static port_t loval() __attribute__ ((always_inline)) { return *port() & ~mask(); }
+	inline static bool isset() __attribute__ ((always_inline)) { return *port() & mask(); }
+};
+
+#define _DEFPIN_POSIX(PIN) template<> class FastPin<PIN> : public _POSIXPIN<PIN> {};
+
+_DEFPIN_POSIX(0); _DEFPIN_POSIX(1); _DEFPIN_POSIX(2); _DEFPIN_POSIX(3);
+_DEFPIN_POSIX(4); _DEFPIN_POSIX(5); _DEFPIN_POSIX(6); _DEFPIN_POSIX(7);
+_DEFPIN_POSIX(8); _DEFPIN_POSIX(9); _DEFPIN_POSIX(10); _DEFPIN_POSIX(11);
+_DEFPIN_POSIX(12); _DEFPIN_POSIX(13); _DEFPIN_POSIX(14); _DEFPIN_POSIX(15);
+_DEFPIN_POSIX(16); _DEFPIN_POSIX(17); _DEFPIN_POSIX(18); _DEFPIN_POSIX(19);
+_DEFPIN_POSIX(20); _DEFPIN_POSIX(21); _DEFPIN_POSIX(22); _DEFPIN_POSIX(23);
+_DEFPIN_POSIX(24); _DEFPIN_POSIX(25); _DEFPIN_POSIX(26); _DEFPIN_POSIX(27);
+_DEFPIN_POSIX(28); _DEFPIN_POSIX(29); _DEFPIN_POSIX(30); _DEFPIN_POSIX(31);
+_DEFPIN_POSIX(32); _DEFPIN_POSIX(33); _DEFPIN_POSIX(34); _DEFPIN_POSIX(35);
+_DEFPIN_POSIX(36); _DEFPIN_POSIX(37); _DEFPIN_POSIX(38); _DEFPIN_POSIX(39);
+_DEFPIN_POSIX(40); _DEFPIN_POSIX(41); _DEFPIN_POSIX(42); _DEFPIN_POSIX(43);
+_DEFPIN_POSIX(44); _DEFPIN_POSIX(45); _DEFPIN_POSIX(46); _DEFPIN_POSIX(47);
+_DEFPIN_POSIX(48); _DEFPIN_POSIX(49); _DEFPIN_POSIX(50); _DEFPIN_POSIX(51);
+_DEFPIN_POSIX(52); _DEFPIN_POSIX(53); _DEFPIN_POSIX(54); _DEFPIN_POSIX(55);
+_DEFPIN_POSIX(56); _DEFPIN_POSIX(57); _DEFPIN_POSIX(58); _DEFPIN_POSIX(59);
+_DEFPIN_POSIX(60); _DEFPIN_POSIX(61); _DEFPIN_POSIX(62); _DEFPIN_POSIX(63);
+
+#define SPI_DATA 0
+#define SPI_CLOCK 1
+
+#define HAS_HARDWARE_PIN_SUPPORT
+
+FASTLED_NAMESPACE_END
+
+#endif
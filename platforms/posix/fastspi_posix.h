@@ -0,0 +1,100 @@
+#ifndef __INC_FASTSPI_POSIX_H
+#define __INC_FASTSPI_POSIX_H
+
+FASTLED_NAMESPACE_BEGIN
+
+/// SPI output for the posix platform.  Everything clocked out between select() and release() is
+/// captured by the sink for the data pin, see sink_posix.h.
+template <uint8_t _DATA_PIN, uint8_t _CLOCK_PIN, uint8_t _SPI_CLOCK_DIVIDER>
+class POSIXSPIOutput {
+	Selectable *m_pSelect;
+
+	static CPosixLEDSink & sink() __attribute__((always_inline)) { return posixSink(_DATA_PIN); }
+
+public:
+	POSIXSPIOutput() { m_pSelect = NULL; }
+	POSIXSPIOutput(Selectable *pSelect) { m_pSelect = pSelect; }
+
+	// set the object representing the selectable
+	void setSelect(Selectable *pSelect) { m_pSelect = pSelect; }
+
+	// initialize the SPI subssytem
+	void init() {
+		FastPin<_DATA_PIN>::setOutput();
+		FastPin<_CLOCK_PIN>::setOutput();
+	}
+
+	// latch the CS select, starts a new transfer in the sink
+	void select() {
+		if(m_pSelect != NULL) { m_pSelect->select(); }
+		sink().begin();
+	}
+
+	// release the CS select, completes the transfer in the sink
+	void release() {
+		if(m_pSelect != NULL) { m_pSelect->release(); }
+		sink().end();
+	}
+
+	// nothing is ever queued up
+	static void wait() __attribute__((always_inline)) { }
+	static void waitFully() __attribute__((always_inline)) { }
+
+	static void writeByteNoWait(uint8_t b) __attribute__((always_inline)) { writeByte(b); }
+	static void writeBytePostWait(uint8_t b) __attribute__((always_inline)) { writeByte(b); }
+
+	// write a byte out via SPI
+	static void writeByte(uint8_t b) __attribute__((always_inline)) { sink().write(b); }
+	// write a word out via SPI
+	static void writeWord(uint16_t w) __attribute__((always_inline)) { writeByte(w>>8); writeByte(w&0xFF); }
+
+	// the sink is byte oriented, single bits are recorded as a full byte holding the bit's value
+	template <uint8_t BIT> inline static void writeBit(uint8_t b) { writeByte((b & (1 << BIT)) ? 1 : 0); }
+
+	// A raw set of writing byte values, assumes setup/init/waiting done elsewhere
+	static void writeBytesValueRaw(uint8_t value, int len) {
+		while(len--) { writeByte(value); }
+	}
+
+	// A full cycle of writing a value for len bytes, including select, release, and waiting
+	void writeBytesValue(uint8_t value, int len) {
+		select(); writeBytesValueRaw(value, len); release();
+	}
+
+	// A full cycle of writing a raw block of data out, including select, release, and waiting
+	template <class D> void writeBytes(register uint8_t *data, int len) {
+		select();
+		uint8_t *end = data + len;
+		while(data != end) { writeByte(D::adjust(*data++)); }
+		D::postBlock(len);
+		release();
+	}
+
+	void writeBytes(register uint8_t *data, int len) { writeBytes<DATA_NOP>(data, len); }
+
+	// write out pixel data from the given PixelController object
+	template <uint8_t FLAGS, class D, EOrder RGB_ORDER> void writePixels(PixelController<RGB_ORDER> pixels) {
+		select();
+		int len = pixels.mLen;
+		while(pixels.has(1)) {
+			if(FLAGS & FLAG_START_BIT) {
+				writeBit<0>(1);
+			}
+			writeByte(D::adjust(pixels.loadAndScale0()));
+			writeByte(D::adjust(pixels.loadAndScale1()));
+			writeByte(D::adjust(pixels.loadAndScale2()));
+			pixels.advanceData();
+			pixels.stepDithering();
+			pixels.stepBayerDithering();
+		}
+		D::postBlock(len);
+		release();
+	}
+};
+
+template<uint8_t _DATA_PIN, uint8_t _CLOCK_PIN, uint8_t _SPI_CLOCK_DIVIDER>
+class SPIOutput : public POSIXSPIOutput<_DATA_PIN, _CLOCK_PIN, _SPI_CLOCK_DIVIDER> {};
+
+FASTLED_NAMESPACE_END
+
+#endif
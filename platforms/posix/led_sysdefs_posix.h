@@ -0,0 +1,73 @@
+#ifndef __INC_LED_SYSDEFS_POSIX_H
+#define __INC_LED_SYSDEFS_POSIX_H
+
+// Native build for Linux/POSIX hosts.  There is no led hardware here, the controllers write their
+// encoded output into in-memory sinks (see sink_posix.h), which makes it possible to build, run and
+// profile the full show() pipeline on a desktop machine.
+
+#ifndef FASTLED_POSIX
+#define FASTLED_POSIX
+#endif
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+
+// Use the monotonic system clock for millis/micros
+#define FASTLED_HAS_MILLIS
+
+typedef volatile uint32_t RoReg;
+typedef volatile uint32_t RwReg;
+typedef uint8_t boolean;
+
+// There is no real cpu clock to count here, F_CPU is only a nominal value used for converting
+// the NS() and DATA_RATE_MHZ() values in the chipset definitions.
+#ifndef F_CPU
+#define F_CPU 64000000L
+#endif
+
+// Default to NOT using PROGMEM here
+#ifndef FASTLED_USE_PROGMEM
+#define FASTLED_USE_PROGMEM 0
+#endif
+
+#ifndef FASTLED_ALLOW_INTERRUPTS
+#define FASTLED_ALLOW_INTERRUPTS 1
+#define INTERRUPT_THRESHOLD 0
+#endif
+
+// No pin/port mapping functions on the host, and every spi pin pair is "hardware" (see fastspi_posix.h)
+#define FASTLED_NO_PINMAP
+#define FASTLED_ALL_PINS_HARDWARE_SPI
+
+#define cli()
+#define sei()
+
+#define FASTLED_NEEDS_YIELD
+extern "C" void yield();
+
+// Microseconds since the first call, from CLOCK_MONOTONIC.  Wraps like the arduino counterparts.
+inline uint64_t posix_micros64() {
+	static uint64_t start = 0;
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	uint64_t now = ((uint64_t)ts.tv_sec * 1000000ULL) + ((uint64_t)ts.tv_nsec / 1000);
+	if(start == 0) { start = now; }
+	return now - start;
+}
+
+inline uint32_t micros() { return (uint32_t)posix_micros64(); }
+inline uint32_t millis() { return (uint32_t)(posix_micros64() / 1000); }
+
+inline void delayMicroseconds(uint32_t us) {
+	struct timespec ts;
+	ts.tv_sec = us / 1000000;
+	ts.tv_nsec = (long)(us % 1000000) * 1000;
+	nanosleep(&ts, NULL);
+}
+
+inline void delay(uint32_t ms) { delayMicroseconds(ms * 1000); }
+
+#endif
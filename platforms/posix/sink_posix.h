@@ -0,0 +1,77 @@
+#ifndef __INC_SINK_POSIX_H
+#define __INC_SINK_POSIX_H
+
+FASTLED_NAMESPACE_BEGIN
+
+#ifndef FASTLED_POSIX_NUM_PINS
+#define FASTLED_POSIX_NUM_PINS 64
+#endif
+
+/// In-memory stand in for the wire.  Controllers on the posix platform write the fully encoded
+/// bytes they would clock out to the leds into the sink for their data pin.  The sink keeps the
+/// bytes of the most recent transfer, plus running totals, so that tests and benchmarks can
+/// inspect the output of show() and measure its cost.
+class CPosixLEDSink {
+	uint8_t *m_pData;
+	uint32_t m_nSize;
+	uint32_t m_nCapacity;
+	uint32_t m_nTransfers;
+	uint64_t m_nTotalBytes;
+
+	void grow(uint32_t nMin) {
+		uint32_t nCap = m_nCapacity ? m_nCapacity : 64;
+		while(nCap < nMin) { nCap <<= 1; }
+		m_pData = (uint8_t*)realloc(m_pData, nCap);
+		m_nCapacity = nCap;
+	}
+
+public:
+	CPosixLEDSink() : m_pData(NULL), m_nSize(0), m_nCapacity(0), m_nTransfers(0), m_nTotalBytes(0) {}
+	~CPosixLEDSink() { free(m_pData); }
+
+	/// start a new transfer, dropping the bytes of the previous one
+	///@param nBytesHint expected size of the transfer, pre-allocates the buffer
+	void begin(uint32_t nBytesHint = 0) {
+		m_nSize = 0;
+		if(nBytesHint > m_nCapacity) { grow(nBytesHint); }
+	}
+
+	/// finish the current transfer
+	void end() {
+		m_nTransfers++;
+		m_nTotalBytes += m_nSize;
+	}
+
+	inline void write(uint8_t b) __attribute__((always_inline)) {
+		if(m_nSize == m_nCapacity) { grow(m_nSize + 1); }
+		m_pData[m_nSize++] = b;
+	}
+
+	void write(const uint8_t *data, uint32_t len) {
+		if(m_nSize + len > m_nCapacity) { grow(m_nSize + len); }
+		memcpy(m_pData + m_nSize, data, len);
+		m_nSize += len;
+	}
+
+	/// forget everything captured so far, including the totals
+	void reset() { m_nSize = 0; m_nTransfers = 0; m_nTotalBytes = 0; }
+
+	/// the bytes of the most recent (or current) transfer
+	const uint8_t *data() const { return m_pData; }
+	/// the number of bytes in the most recent (or current) transfer
+	uint32_t size() const { return m_nSize; }
+	/// how many transfers have been completed since the last reset
+	uint32_t transfers() const { return m_nTransfers; }
+	/// how many bytes have been written by completed transfers since the last reset
+	uint64_t totalBytes() const { return m_nTotalBytes; }
+};
+
+/// Get the sink that captures the output written to the given data pin
+inline CPosixLEDSink & posixSink(uint8_t pin) {
+	static CPosixLEDSink sinks[FASTLED_POSIX_NUM_PINS];
+	return sinks[pin % FASTLED_POSIX_NUM_PINS];
+}
+
+FASTLED_NAMESPACE_END
+
+#endif
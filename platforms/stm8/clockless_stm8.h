@@ -42,6 +42,8 @@ public:
   virtual inline void init() { FastPin<DATA_PIN>::setOutput(PushPull_Fast); }
   //OPTIMIZE_SIZE
   virtual inline uint16_t getMaxRefreshRate() const { return 400; }
+  // dithering and scaling happen in asm, which doesn't know about raw data
+  virtual bool canShowRaw() const { return false; }
 
 protected:
 
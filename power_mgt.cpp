@@ -2,6 +2,23 @@
 #include "FastLED.h"
 #include "power_mgt.h"
 
+// Pick an implementation for summing up the color channels
+#if defined(__AVX2__)
+#define CHANNEL_SUMS_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#define CHANNEL_SUMS_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define CHANNEL_SUMS_NEON 1
+#include <arm_neon.h>
+#elif defined(FASTLED_TEENSY3)
+// Can use Cortex M4 DSP instructions
+#define CHANNEL_SUMS_ARM_DSP_ASM 1
+#else
+#define CHANNEL_SUMS_C 1
+#endif
+
 FASTLED_NAMESPACE_BEGIN
 
 //// POWER MANAGEMENT
@@ -47,14 +64,126 @@ static const uint8_t gMCU_mW  =  25 * 5; // 25mA @ 5v = 125 mW
 static uint8_t  gMaxPowerIndicatorLEDPinNumber = 0; // default = Arduino onboard LED pin.  set to zero to skip this.
 
 
-uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds ) //25354
+#if (CHANNEL_SUMS_SSE2 == 1) || (CHANNEL_SUMS_AVX2 == 1)
+// byte masks selecting one color channel out of 96 bytes (32 leds) of led data
+#define CHANNEL_SEL4(a,b,c) a,b,c,a,b,c,a,b,c,a,b,c
+#define CHANNEL_SEL32(a,b,c) CHANNEL_SEL4(a,b,c), CHANNEL_SEL4(a,b,c), CHANNEL_SEL4(a,b,c), CHANNEL_SEL4(a,b,c), \
+                             CHANNEL_SEL4(a,b,c), CHANNEL_SEL4(a,b,c), CHANNEL_SEL4(a,b,c), CHANNEL_SEL4(a,b,c)
+static const uint8_t gChannelSel[3][96] = {
+    { CHANNEL_SEL32(0xFF, 0, 0) },
+    { CHANNEL_SEL32(0, 0xFF, 0) },
+    { CHANNEL_SEL32(0, 0, 0xFF) }
+};
+#endif
+
+#if CHANNEL_SUMS_ARM_DSP_ASM == 1
+// add up the bytes of x that are selected by mask
+#define USADA8_MASKED(acc, x, mask) asm volatile( "usada8 %0, %1, %2, %0" : "+r" (acc) : "r" ((x) & (mask)), "r" (0))
+#endif
+
+void calculate_channel_sums( const CRGB* ledbuffer, uint16_t numLeds, uint32_t sums[3])
 {
     uint32_t red32 = 0, green32 = 0, blue32 = 0;
-    const CRGB* firstled = &(ledbuffer[0]);
-    uint8_t* p = (uint8_t*)(firstled);
-
+    const uint8_t* p = (const uint8_t*)ledbuffer;
     uint16_t count = numLeds;
 
+#if CHANNEL_SUMS_AVX2 == 1
+    // 32 leds at a time: mask out one channel of each 32 byte vector and let
+    // sad_epu8 add up its bytes into four 64 bit lanes
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc[3], sel[3][3];
+    for(int c = 0; c < 3; c++) {
+        acc[c] = zero;
+        for(int j = 0; j < 3; j++) { sel[c][j] = _mm256_loadu_si256((const __m256i*)(gChannelSel[c] + (j * 32))); }
+    }
+    while(count >= 32) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i*)p);
+        __m256i v1 = _mm256_loadu_si256((const __m256i*)(p + 32));
+        __m256i v2 = _mm256_loadu_si256((const __m256i*)(p + 64));
+        for(int c = 0; c < 3; c++) {
+            acc[c] = _mm256_add_epi64(acc[c], _mm256_sad_epu8(_mm256_and_si256(v0, sel[c][0]), zero));
+            acc[c] = _mm256_add_epi64(acc[c], _mm256_sad_epu8(_mm256_and_si256(v1, sel[c][1]), zero));
+            acc[c] = _mm256_add_epi64(acc[c], _mm256_sad_epu8(_mm256_and_si256(v2, sel[c][2]), zero));
+        }
+        p += 96;
+        count -= 32;
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc[0]); red32   = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm256_storeu_si256((__m256i*)lanes, acc[1]); green32 = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm256_storeu_si256((__m256i*)lanes, acc[2]); blue32  = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif CHANNEL_SUMS_SSE2 == 1
+    // 16 leds at a time: mask out one channel of each 16 byte vector and let
+    // sad_epu8 add up its bytes into two 64 bit lanes
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc[3], sel[3][3];
+    for(int c = 0; c < 3; c++) {
+        acc[c] = zero;
+        for(int j = 0; j < 3; j++) { sel[c][j] = _mm_loadu_si128((const __m128i*)(gChannelSel[c] + (j * 16))); }
+    }
+    while(count >= 16) {
+        __m128i v0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(p + 16));
+        __m128i v2 = _mm_loadu_si128((const __m128i*)(p + 32));
+        for(int c = 0; c < 3; c++) {
+            acc[c] = _mm_add_epi64(acc[c], _mm_sad_epu8(_mm_and_si128(v0, sel[c][0]), zero));
+            acc[c] = _mm_add_epi64(acc[c], _mm_sad_epu8(_mm_and_si128(v1, sel[c][1]), zero));
+            acc[c] = _mm_add_epi64(acc[c], _mm_sad_epu8(_mm_and_si128(v2, sel[c][2]), zero));
+        }
+        p += 48;
+        count -= 16;
+    }
+    red32   = _mm_cvtsi128_si32(acc[0]) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(acc[0], acc[0]));
+    green32 = _mm_cvtsi128_si32(acc[1]) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(acc[1], acc[1]));
+    blue32  = _mm_cvtsi128_si32(acc[2]) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(acc[2], acc[2]));
+#elif CHANNEL_SUMS_NEON == 1
+    // 16 leds at a time: vld3 splits the channels apart, and pairwise adds
+    // accumulate them into 16 bit lanes - which get flushed into 32 bit
+    // lanes every 128 rounds, before they can overflow
+    uint32x4_t r32 = vdupq_n_u32(0), g32 = vdupq_n_u32(0), b32 = vdupq_n_u32(0);
+    while(count >= 16) {
+        uint16x8_t r16 = vdupq_n_u16(0), g16 = vdupq_n_u16(0), b16 = vdupq_n_u16(0);
+        uint16_t rounds = count / 16;
+        if(rounds > 128) { rounds = 128; }
+        count -= rounds * 16;
+        while(rounds--) {
+            uint8x16x3_t rgb = vld3q_u8(p);
+            r16 = vpadalq_u8(r16, rgb.val[0]);
+            g16 = vpadalq_u8(g16, rgb.val[1]);
+            b16 = vpadalq_u8(b16, rgb.val[2]);
+            p += 48;
+        }
+        r32 = vpadalq_u16(r32, r16);
+        g32 = vpadalq_u16(g32, g16);
+        b32 = vpadalq_u16(b32, b16);
+    }
+    uint64x2_t r64 = vpaddlq_u32(r32), g64 = vpaddlq_u32(g32), b64 = vpaddlq_u32(b32);
+    red32   = vgetq_lane_u64(r64, 0) + vgetq_lane_u64(r64, 1);
+    green32 = vgetq_lane_u64(g64, 0) + vgetq_lane_u64(g64, 1);
+    blue32  = vgetq_lane_u64(b64, 0) + vgetq_lane_u64(b64, 1);
+#elif CHANNEL_SUMS_ARM_DSP_ASM == 1
+    // 4 leds (3 words) at a time, usada8 adds up the bytes of each channel
+    // in a word - the M4 is fine with the unaligned loads
+    while(count >= 4) {
+        uint32_t w0, w1, w2;
+        memcpy(&w0, p, 4);
+        memcpy(&w1, p + 4, 4);
+        memcpy(&w2, p + 8, 4);
+        // w0 = r0 g0 b0 r1, w1 = g1 b1 r2 g2, w2 = b2 r3 g3 b3 (lowest byte first)
+        USADA8_MASKED(red32,   w0, 0xFF0000FF);
+        USADA8_MASKED(red32,   w1, 0x00FF0000);
+        USADA8_MASKED(red32,   w2, 0x0000FF00);
+        USADA8_MASKED(green32, w0, 0x0000FF00);
+        USADA8_MASKED(green32, w1, 0xFF0000FF);
+        USADA8_MASKED(green32, w2, 0x00FF0000);
+        USADA8_MASKED(blue32,  w0, 0x00FF0000);
+        USADA8_MASKED(blue32,  w1, 0x0000FF00);
+        USADA8_MASKED(blue32,  w2, 0xFF0000FF);
+        p += 12;
+        count -= 4;
+    }
+#endif
+
     // This loop might benefit from an AVR assembly version -MEK
     while( count) {
         red32   += *p++;
@@ -63,6 +192,37 @@ uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds )
         count--;
     }
 
+    sums[0] = red32;
+    sums[1] = green32;
+    sums[2] = blue32;
+}
+
+const uint32_t *CLEDController::getChannelSums()
+{
+    if(m_pLeds16) {
+        // m_Data only holds the last frame written out, already scaled - sum the top bytes of the 16 bit leds
+        m_nChannelSums[0] = m_nChannelSums[1] = m_nChannelSums[2] = 0;
+        for(int i = 0; i < m_nLeds; i++) {
+            m_nChannelSums[0] += m_pLeds16[i].r >> 8;
+            m_nChannelSums[1] += m_pLeds16[i].g >> 8;
+            m_nChannelSums[2] += m_pLeds16[i].b >> 8;
+        }
+    } else if(!m_bTrackWrites || !m_bSumsValid) {
+        calculate_channel_sums( m_Data, m_nLeds, m_nChannelSums);
+        m_bSumsValid = true;
+    }
+    return m_nChannelSums;
+}
+
+uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds ) //25354
+{
+    uint32_t sums[3];
+    calculate_channel_sums( ledbuffer, numLeds, sums);
+    return calculate_unscaled_power_mW( sums[0], sums[1], sums[2], numLeds);
+}
+
+uint32_t calculate_unscaled_power_mW( uint32_t red32, uint32_t green32, uint32_t blue32, uint16_t numLeds )
+{
     red32   *= gRed_mW;
     green32 *= gGreen_mW;
     blue32  *= gBlue_mW;
@@ -97,16 +257,39 @@ uint8_t calculate_max_brightness_for_power_mW(const CRGB* ledbuffer, uint16_t nu
 // sets brightness to
 //  - no more than target_brightness
 //  - no more than max_mW milliwatts
-uint8_t calculate_max_brightness_for_power_mW( uint8_t target_brightness, uint32_t max_power_mW)
+uint32_t calculate_unscaled_power_mW()
+{
+    return calculate_unscaled_power_mW( NULL);
+}
+
+uint32_t calculate_unscaled_power_mW( uint32_t zone_mW[FASTLED_POWER_ZONES])
 {
     uint32_t total_mW = gMCU_mW;
 
-    CLEDController *pCur = CLEDController::head();
-	while(pCur) {
-        total_mW += calculate_unscaled_power_mW( pCur->leds(), pCur->size());
-		pCur = pCur->next();
-	}
+    if( zone_mW) {
+        for(uint8_t z = 0; z < FASTLED_POWER_ZONES; z++) { zone_mW[z] = 0; }
+    }
+
+    for(uint8_t i = 0; i < CLEDController::count(); i++) {
+        CLEDController *pCur = CLEDController::controller(i);
+        // the controller caches the channel sums if it tracks writes to its leds
+        const uint32_t *sums = pCur->getChannelSums();
+        uint32_t led_mW = calculate_unscaled_power_mW( sums[0], sums[1], sums[2], pCur->size());
+        total_mW += led_mW;
+        uint8_t zone = pCur->getPowerZone();
+        if( zone_mW && zone) { zone_mW[zone-1] += led_mW; }
+    }
+
+    return total_mW;
+}
 
+uint8_t calculate_max_brightness_for_power_mW( uint8_t target_brightness, uint32_t max_power_mW)
+{
+    return calculate_max_brightness_for_unscaled_power_mW( calculate_unscaled_power_mW(), target_brightness, max_power_mW);
+}
+
+uint8_t calculate_max_brightness_for_unscaled_power_mW( uint32_t total_mW, uint8_t target_brightness, uint32_t max_power_mW)
+{
 #if POWER_DEBUG_PRINT == 1
     Serial.print("power demand at full brightness mW = ");
     Serial.println( total_mW);
@@ -155,6 +338,17 @@ uint8_t calculate_max_brightness_for_power_mW( uint8_t target_brightness, uint32
     return recommended_brightness;
 }
 
+uint8_t calculate_max_brightness_for_zone_mW( uint32_t zone_mW, uint8_t target_brightness, uint32_t max_power_mW)
+{
+    // the same limit as for all the leds, minus the indicator led and debug output, which go by the global limit
+    uint32_t requested_power_mW = ((uint32_t)zone_mW * target_brightness) / 256;
+    if( requested_power_mW < max_power_mW) {
+        return target_brightness;
+    }
+
+    return (uint32_t)((uint8_t)(target_brightness) * (uint32_t)(max_power_mW)) / ((uint32_t)(requested_power_mW));
+}
+
 
 void set_max_power_indicator_LED( uint8_t pinNumber)
 {
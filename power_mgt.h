@@ -58,6 +58,39 @@ void delay_at_max_brightness_for_power( uint16_t ms);
 ///
 uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds);
 
+/// calculate_channel_sums adds up the red, green and blue values of
+///   numLeds leds, into sums[0], sums[1] and sums[2].  Uses SIMD
+///   instructions where available (SSE2/AVX2, NEON, Cortex M4 DSP).
+///
+void calculate_channel_sums( const CRGB* ledbuffer, uint16_t numLeds, uint32_t sums[3]);
+
+/// calculate_unscaled_power_mW from the sums of the red, green and blue
+///   channels of numLeds leds (see CLEDController::getChannelSums).
+///
+uint32_t calculate_unscaled_power_mW( uint32_t red32, uint32_t green32, uint32_t blue32, uint16_t numLeds);
+
+/// calculate_unscaled_power_mW for the leds of all controllers, plus
+///   the power used by the MCU itself.
+///
+uint32_t calculate_unscaled_power_mW();
+
+/// calculate_unscaled_power_mW for the leds of all controllers, plus
+///   the power used by the MCU itself.  In the same pass, the power of
+///   the leds in each power zone gets added up into zone_mW.
+///
+uint32_t calculate_unscaled_power_mW( uint32_t zone_mW[FASTLED_POWER_ZONES]);
+
+/// calculate_max_brightness_for_unscaled_power_mW tells you the highest
+///   brightness level you can use and still stay under the specified
+///   power budget, for leds that would draw unscaled_mW milliwatts at
+///   brightness = 255 (see calculate_unscaled_power_mW).  The result from
+///   this function will be no higher than the target_brightess you supply,
+///   but may be lower.  It is the second half of
+///   calculate_max_brightness_for_power_mW, so it drives the max power
+///   indicator led (see set_max_power_indicator_LED) and prints the
+///   POWER_DEBUG_PRINT output in the same way.
+uint8_t calculate_max_brightness_for_unscaled_power_mW( uint32_t unscaled_mW, uint8_t target_brightness, uint32_t max_power_mW);
+
 /// calculate_max_brightness_for_power_mW tells you the highest brightness
 ///   level you can use and still stay under the specified power budget for 
 ///   a given set of leds.  It takes a pointer to an array of CRGB objects, a
@@ -81,6 +114,16 @@ uint8_t calculate_max_brightness_for_power_vmA(const CRGB* ledbuffer, uint16_t n
 ///   target_brightess you supply, but may be lower.
 uint8_t  calculate_max_brightness_for_power_mW( uint8_t target_brightness, uint32_t max_power_mW);
 
+/// calculate_max_brightness_for_zone_mW tells you the highest brightness
+///   level you can use and still stay under the specified power budget
+///   for the leds of a power zone (see CLEDController::setPowerZone), which
+///   would draw zone_mW milliwatts at brightness = 255 (see the zone_mW
+///   version of calculate_unscaled_power_mW).  The result from this
+///   function will be no higher than the target_brightess you supply, but
+///   may be lower.  Unlike calculate_max_brightness_for_unscaled_power_mW,
+///   it leaves the max power indicator led alone.
+uint8_t  calculate_max_brightness_for_zone_mW( uint32_t zone_mW, uint8_t target_brightness, uint32_t max_power_mW);
+
 FASTLED_NAMESPACE_END
 ///@}
 // POWER_MGT_H
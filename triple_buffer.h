@@ -0,0 +1,107 @@
+#ifndef __INC_FL_TRIPLE_BUFFER_H
+#define __INC_FL_TRIPLE_BUFFER_H
+
+#include "FastLED.h"
+
+///@file triple_buffer.h
+/// Lock-free handoff of led frames from a rendering task to the task calling FastLED.show()
+
+FASTLED_NAMESPACE_BEGIN
+
+struct CRGB;
+
+/// Three led arrays shared between a renderer and the output side, so that one task (or core) can draw frames
+/// while another writes them out.  The renderer draws into back() and hands the frame over with publish(), the
+/// output side picks up the newest published frame with acquire() and writes out front().  Neither side ever
+/// waits for the other or copies led data, and neither sees a half drawn frame - if the renderer is faster,
+/// frames the output side never got to are dropped, and if it is slower the last frame is written out again.
+///
+/// Attach it to a controller with CLEDController::setLeds(CTripleBuffer &, int), and FastLED.show() acquires
+/// the newest frame by itself.  The arrays are provided by the caller, like the leds passed to addLeds.  Note
+/// that back() doesn't hold the frame that was just published, so effects building on the previous frame need
+/// to draw the whole frame again, or copy it over first.
+class CTripleBuffer {
+	/// set in m_nMiddle if the middle buffer holds a frame the output side hasn't picked up yet
+	static const uint8_t FRESH = 0x80;
+
+	CRGB *m_pBuffers[3];
+	volatile uint8_t m_nMiddle;     ///< buffer passed between the two sides, plus the FRESH flag
+	uint8_t m_nBack;                ///< buffer owned by the renderer
+	uint8_t m_nFront;               ///< buffer owned by the output side
+
+	/// store v into *p, returning the old value, as a single atomic step
+	static uint8_t exchange(volatile uint8_t *p, uint8_t v) {
+#if defined(__AVR__)
+		uint8_t sreg = SREG;
+		cli();
+		uint8_t old = *p;
+		*p = v;
+		SREG = sreg;
+		return old;
+#elif defined(__GCC_ATOMIC_CHAR_LOCK_FREE) && (__GCC_ATOMIC_CHAR_LOCK_FREE == 2)
+		return __atomic_exchange_n(p, v, __ATOMIC_ACQ_REL);
+#elif defined(ESP8266)
+		// single core parts without atomic instructions - keep interrupts off if the caller had them off
+		uint32_t ps = xt_rsil(15);
+		uint8_t old = *p;
+		*p = v;
+		xt_wsr_ps(ps);
+		return old;
+#elif defined(__arm__)
+		uint32_t primask;
+		__asm__ __volatile__("mrs %0, primask" : "=r" (primask));
+		cli();
+		uint8_t old = *p;
+		*p = v;
+		__asm__ __volatile__("msr primask, %0" : : "r" (primask) : "memory");
+		return old;
+#else
+		// nothing to save the interrupt state with, they end up on again
+		cli();
+		uint8_t old = *p;
+		*p = v;
+		sei();
+		return old;
+#endif
+	}
+
+	/// read *p, making sure the frame behind it is visible to this side
+	static uint8_t load(volatile uint8_t *p) {
+#if !defined(__AVR__) && defined(__GCC_ATOMIC_CHAR_LOCK_FREE) && (__GCC_ATOMIC_CHAR_LOCK_FREE == 2)
+		return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#else
+		return *p;
+#endif
+	}
+
+public:
+	/// set up the buffer with three arrays of the same number of leds
+	CTripleBuffer(CRGB *pFirst, CRGB *pSecond, CRGB *pThird) : m_nMiddle(1), m_nBack(0), m_nFront(2) {
+		m_pBuffers[0] = pFirst;
+		m_pBuffers[1] = pSecond;
+		m_pBuffers[2] = pThird;
+	}
+
+	/// the leds for the renderer to draw the next frame into
+	CRGB *back() { return m_pBuffers[m_nBack]; }
+
+	/// hand the frame drawn into back() over to the output side.  back() moves on to another buffer
+	void publish() {
+		m_nBack = exchange(&m_nMiddle, m_nBack | FRESH) & 0x03;
+	}
+
+	/// pick up the newest published frame for writing out, if there is one
+	///@returns true if front() moved on to a new frame
+	bool acquire() {
+		if(!(load(&m_nMiddle) & FRESH)) { return false; }
+		m_nFront = exchange(&m_nMiddle, m_nFront) & 0x03;
+		return true;
+	}
+
+	/// the leds of the frame the output side is writing out
+	CRGB *front() { return m_pBuffers[m_nFront]; }
+};
+
+FASTLED_NAMESPACE_END
+
+#endif